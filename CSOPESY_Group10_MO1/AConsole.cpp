@@ -2,20 +2,44 @@
 #include <ctime>
 #include <iostream>
 #include <fstream>
-#include <random>
 #include <thread>
 #include "AConsole.h"
+#include "ProcessLogger.h"
+#include "Platform.h"
+#include "Workload.h"
 
-static int processCounter = 0;
+/*
+* This constructor instantiates a new console given its process ID, name, and instruction total
+*
+* @param processID - the process ID of the console
+* @param name - the name of the console
+* @param instructionTotal - the total number of instructions
+*/
+AConsole::AConsole(int processID, const std::string& name, int instructionTotal)
+    : processID(processID), name(name), createdAt(std::time(0)), instructionLine(0), instructionTotal(instructionTotal), coreID(-1), status(WAITING), isActive(true) {}
 
 /*
-* This constructor instantiates a new console given its name, instruction line, and instruction total
+* This constructor instantiates a console with a known creation timestamp,
+* used when restoring a checkpoint
 *
+* @param processID - the process ID of the console
 * @param name - the name of the console
 * @param instructionTotal - the total number of instructions
+* @param timestamp - the time the console was originally created
 */
-AConsole::AConsole(const std::string& name, int instructionTotal)
-    : name(name), processID(++processCounter), instructionLine(0), instructionTotal(instructionTotal), isActive(true), status(WAITING), coreID(-1), timestamp(getCurrentTime()) {}
+AConsole::AConsole(int processID, const std::string& name, int instructionTotal, const std::string& timestamp)
+    : processID(processID), name(name), timestamp(timestamp), instructionLine(0), instructionTotal(instructionTotal), coreID(-1), status(WAITING), isActive(true) {}
+
+/*
+* This constructor instantiates a console admitted in bulk. It has no stored
+* name: getName derives one from the process ID when something asks for it.
+*
+* @param processID - the process ID of the console
+* @param instructionTotal - the total number of instructions
+* @param createdAt - the time the console was created
+*/
+AConsole::AConsole(int processID, int instructionTotal, time_t createdAt)
+    : processID(processID), createdAt(createdAt), instructionLine(0), instructionTotal(instructionTotal), coreID(-1), status(WAITING), isActive(true) {}
 
 /*
  * This function simulates the execution of a process on a specified CPU core.
@@ -36,15 +60,10 @@ AConsole::AConsole(const std::string& name, int instructionTotal)
  * @param delaysPerExec   - The number of CPU cycles to busy-wait before executing the
  *                          next instruction. A value of 0 means no waiting, allowing
  *                          immediate execution of the next instruction.
+ * @param counters        - The activity counters of the core, or nullptr.
  */
-void AConsole::runProcess(int coreID, int quantum_cycles, int delaysPerExec) {
-    this->coreID = coreID;
-    getCurrentTime();
-    status = RUNNING;
-
-    random_device rd;
-    knuth_b knuth_gen(rd());
-    uniform_int_distribution<> dist(10, 20);
+void AConsole::runProcess(int coreID, int quantum_cycles, int delaysPerExec, CoreCounters* counters) {
+    dispatch(coreID);
 
     int executedInstructions = 0;
 
@@ -56,20 +75,176 @@ void AConsole::runProcess(int coreID, int quantum_cycles, int delaysPerExec) {
         }
 
         if (quantum_cycles > 0 && executedInstructions >= quantum_cycles) {
-            status = WAITING;
+            preempt();
+            if (counters != nullptr) {
+                CoreCounters::add(counters->preemptions, 1);
+            }
             break;
         }
 
         // Introduce a random delay for realism, so everything won't be instant
-        this_thread::sleep_for(chrono::milliseconds(dist(knuth_gen)));
+        this_thread::sleep_for(chrono::milliseconds(Workload::instructionDelay(delaySeed, instructionLine)));
 
-        instructionLine++;
+        executeInstruction();
         executedInstructions++;
+        if (counters != nullptr) {
+            CoreCounters::add(counters->instructions, 1);
+        }
+
+        // A SLEEP instruction holds the core for extra ticks
+        if (getSleepTicks() > 0) {
+            this_thread::sleep_for(chrono::milliseconds(getSleepTicks()));
+        }
     }
+}
 
-    if (instructionLine == instructionTotal) {
-        status = TERMINATED;
+/*
+* This function marks the console as running on the specified core
+*
+* @param coreID - the ID of the CPU core the console was dispatched to
+*/
+void AConsole::dispatch(int coreID) {
+    // Compile the process body the first time it reaches a core. The body is
+    // seeded from the delay seed, which comes from the workload seed, so a
+    // seeded, replayed or restored run executes the same programs. A restored
+    // process replays its program up to the saved line to rebuild its
+    // variables and loop counters.
+    if (program.empty()) {
+        program = Program::generate(instructionTotal.load(memory_order_relaxed), FastRandom::mix(delaySeed));
+        programState = Program::State();
+        program.skip(programState, instructionLine.load(memory_order_relaxed));
+    }
+    if (pageTable == nullptr && pagingManager.isEnabled()) {
+        pageTable = pagingManager.attach(processID);
     }
+
+    unsigned int sequence = beginUpdate();
+    this->coreID.store(coreID, memory_order_relaxed);
+    status.store(RUNNING, memory_order_relaxed);
+    endUpdate(sequence);
+}
+
+/*
+* This function executes the next instruction of the console's program and
+* marks it as terminated once the last instruction has been executed
+*
+* @return true if the console still has instructions left, false otherwise
+*/
+bool AConsole::executeInstruction() {
+    program.run(programState, 1);
+
+    // Touch the page holding the next instruction and the variable that was
+    // written; a page that is not resident is faulted in here
+    if (pageTable != nullptr) {
+        pagingManager.access(pageTable, Program::SYMBOL_TABLE_SIZE + programState.pc * sizeof(Program::Instruction));
+        if (programState.lastOp == Program::DECLARE || programState.lastOp == Program::ADD || programState.lastOp == Program::SUBTRACT) {
+            pagingManager.access(pageTable, programState.lastDst * sizeof(uint16_t));
+        }
+    }
+
+    unsigned int sequence = beginUpdate();
+    int line = instructionLine.load(memory_order_relaxed) + 1;
+    instructionLine.store(line, memory_order_relaxed);
+
+    bool hasMore = line < instructionTotal.load(memory_order_relaxed);
+    if (!hasMore) {
+        status.store(TERMINATED, memory_order_relaxed);
+        finishedNs = monotonicNs();
+    }
+    endUpdate(sequence);
+
+    int core = coreID.load(memory_order_relaxed);
+    processLogger.logInstruction(core, processID, logSequence, line, programState.lastOp, programState.lastDst,
+        programState.lastOp == Program::SLEEP ? programState.sleepTicks : programState.variables[programState.lastDst]);
+
+    if (!hasMore) {
+        processLogger.logFinished(core, processID, logSequence, line);
+        program.clear();
+    }
+    return hasMore;
+}
+
+/*
+* This function returns the number of ticks the last executed instruction
+* asked the core to sleep for
+*
+* @return the sleep ticks, 0 if the last instruction was not a SLEEP
+*/
+int AConsole::getSleepTicks() const {
+    return programState.sleepTicks;
+}
+
+/*
+* This function marks the console as waiting after it used up its quantum
+*/
+void AConsole::preempt() {
+    lastPreemptNs = monotonicNs();
+    unsigned int sequence = beginUpdate();
+    status.store(WAITING, memory_order_relaxed);
+    endUpdate(sequence);
+}
+
+/*
+* This function restores the progress saved in a checkpoint. It must be
+* called before the console is handed to the scheduler.
+*
+* @param instructionLine - the saved instruction line
+* @param coreID - the core the console last ran on
+* @param status - the saved status
+*/
+void AConsole::restoreState(int instructionLine, int coreID, Status status) {
+    unsigned int sequence = beginUpdate();
+    this->instructionLine.store(instructionLine, memory_order_relaxed);
+    this->coreID.store(coreID, memory_order_relaxed);
+    this->status.store(status, memory_order_relaxed);
+    endUpdate(sequence);
+}
+
+/*
+* This function opens a seqlock write section. Only the core that owns the
+* console writes, so a plain store is enough to make the sequence odd.
+*
+* @return the sequence number to pass to endUpdate
+*/
+unsigned int AConsole::beginUpdate() {
+    unsigned int sequence = stateSequence.load(memory_order_relaxed);
+    stateSequence.store(sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    return sequence;
+}
+
+/*
+* This function closes a seqlock write section, publishing the new state
+*
+* @param sequence - the value returned by beginUpdate
+*/
+void AConsole::endUpdate(unsigned int sequence) {
+    stateSequence.store(sequence + 2, memory_order_release);
+}
+
+/*
+* This function takes a consistent snapshot of the fields a core updates.
+* It never blocks the core; if an update races with the read it simply reads
+* again.
+*
+* @return snapshot - the instruction line, total, core ID and status
+*/
+AConsole::Snapshot AConsole::snapshot() const {
+    Snapshot snap;
+    unsigned int before;
+    unsigned int after;
+
+    do {
+        before = stateSequence.load(memory_order_acquire);
+        snap.instructionLine = instructionLine.load(memory_order_relaxed);
+        snap.instructionTotal = instructionTotal.load(memory_order_relaxed);
+        snap.coreID = coreID.load(memory_order_relaxed);
+        snap.status = status.load(memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        after = stateSequence.load(memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+
+    return snap;
 }
 
 /*
@@ -78,15 +253,95 @@ void AConsole::runProcess(int coreID, int quantum_cycles, int delaysPerExec) {
 * @return name - the name of the console
 */
 std::string AConsole::getName() const {
+    return name.empty() ? nameForPid(processID) : name;
+}
+
+/*
+* This function returns the name the console was given, without deriving one
+* from the PID, so it can be copied cheaply while the process lists are locked
+*
+* @return name - the stored name, empty if the name is derived from the PID
+*/
+const std::string& AConsole::getStoredName() const {
     return name;
 }
 
+/*
+* This function checks whether the console's name is derived from its PID
+*
+* @return true if the console was admitted without a stored name
+*/
+bool AConsole::hasGeneratedName() const {
+    return name.empty();
+}
+
+/*
+* This function compares the console's name without copying it
+*
+* @param name - the name to compare with
+* @return true if the console has this name
+*/
+bool AConsole::hasName(const std::string& name) const {
+    return this->name.empty() ? pidForName(name) == processID : this->name == name;
+}
+
+/*
+* This function returns the name of a console admitted in bulk
+*
+* @param pid - the process ID
+* @return the name, "process" and the PID zero-padded to three digits
+*/
+std::string AConsole::nameForPid(int pid) {
+    std::string digits = to_string(pid);
+    if (digits.size() < 3) digits.insert(0, 3 - digits.size(), '0');
+    return "process" + digits;
+}
+
+/*
+* This function returns the PID a name would be derived from
+*
+* @param name - the name
+* @return the PID, or -1 if nameForPid never returns this name
+*/
+int AConsole::pidForName(const std::string& name) {
+    const std::string prefix = "process";
+    if (name.size() < prefix.size() + 3 || name.size() > prefix.size() + 9 || name.compare(0, prefix.size(), prefix) != 0) {
+        return -1;
+    }
+
+    int pid = 0;
+    for (size_t i = prefix.size(); i < name.size(); ++i) {
+        if (name[i] < '0' || name[i] > '9') return -1;
+        pid = pid * 10 + (name[i] - '0');
+    }
+    return nameForPid(pid) == name ? pid : -1;
+}
+
 /*
 * This function returns the timestamp when the console was created
 *
 * @return timestamp - the timestamp when the console was created
 */
 std::string AConsole::getTimestamp() const {
+    return timestamp.empty() ? formatTime(createdAt) : timestamp;
+}
+
+/*
+* This function returns the raw creation time, which is cheap to copy while
+* the process lists are locked
+*
+* @return createdAt - the time the console was created, 0 for a restored console
+*/
+std::time_t AConsole::getCreatedAt() const {
+    return createdAt;
+}
+
+/*
+* This function returns the timestamp a restored console was checkpointed with
+*
+* @return timestamp - the restored timestamp, empty if the console was not restored
+*/
+const std::string& AConsole::getRestoredTimestamp() const {
     return timestamp;
 }
 
@@ -171,6 +426,26 @@ void AConsole::setProcessID(int id) {
     processID = id;
 }
 
+/*
+* This function returns the seed of the console's per-instruction delays and
+* program body
+*
+* @return the delay seed
+*/
+uint64_t AConsole::getDelaySeed() const {
+    return delaySeed;
+}
+
+/*
+* This function sets the seed of the console's per-instruction delays and
+* program body
+*
+* @param seed - the delay seed
+*/
+void AConsole::setDelaySeed(uint64_t seed) {
+    delaySeed = seed;
+}
+
 /*
 * This function sets the active status of the console
 *
@@ -181,14 +456,120 @@ void AConsole::setIsActive(bool active) {
 }
 
 /*
-* This function returns the current time in the format (MM/DD/YYYY HH:MM:SS AM/PM)
+* This function records the moment the console was placed in the waiting queue
+*/
+void AConsole::markEnqueued() {
+    markEnqueued(chrono::steady_clock::now());
+}
+
+/*
+* This function records the moment the console was placed in the waiting
+* queue, for callers that enqueue a batch at one time
+*
+* @param now - the time it was enqueued
+*/
+void AConsole::markEnqueued(chrono::steady_clock::time_point now) {
+    enqueueTime = now;
+    if (arrivalNs == 0) {
+        arrivalNs = chrono::duration_cast<chrono::nanoseconds>(enqueueTime.time_since_epoch()).count();
+    }
+}
+
+/*
+* This function records the moment the console starts a slice on a core
+*
+* @param nowNs - the current steady-clock time in nanoseconds
+*/
+void AConsole::markDispatched(int64_t nowNs) {
+    if (firstDispatchNs == 0) {
+        firstDispatchNs = nowNs;
+    }
+    lastDispatchNs = nowNs;
+}
+
+/*
+* This function returns the moment the console was first placed in the waiting queue
+*
+* @return arrivalNs - the arrival time in nanoseconds
+*/
+int64_t AConsole::getArrivalNs() const {
+    return arrivalNs;
+}
+
+/*
+* This function returns the moment the console first ran on a core
+*
+* @return firstDispatchNs - the first dispatch time in nanoseconds, 0 if it has not run
+*/
+int64_t AConsole::getFirstDispatchNs() const {
+    return firstDispatchNs;
+}
+
+/*
+* This function returns the moment the console's latest slice started
+*
+* @return lastDispatchNs - the last dispatch time in nanoseconds, 0 if it has not run
+*/
+int64_t AConsole::getLastDispatchNs() const {
+    return lastDispatchNs;
+}
+
+/*
+* This function returns the moment the console was last preempted
+*
+* @return lastPreemptNs - the last preemption time in nanoseconds, 0 if never preempted
+*/
+int64_t AConsole::getLastPreemptNs() const {
+    return lastPreemptNs;
+}
+
+/*
+* This function returns the moment the console executed its last instruction
+*
+* @return finishedNs - the termination time in nanoseconds, 0 if it has not finished
+*/
+int64_t AConsole::getFinishedNs() const {
+    return finishedNs;
+}
+
+/*
+* This function returns the steady clock in nanoseconds, the time base of the
+* console's scheduling timestamps
+*
+* @return the current time in nanoseconds
+*/
+int64_t AConsole::monotonicNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+* This function returns the moment the console was last placed in the waiting queue
+*
+* @return enqueueTime - the time the console was last enqueued
+*/
+chrono::steady_clock::time_point AConsole::getEnqueueTime() const {
+    return enqueueTime;
+}
+
+/*
+* This function returns the scheduling policy's bookkeeping for the console
+*
+* @return schedulingInfo - the policy's per-process data
+*/
+AConsole::SchedulingInfo& AConsole::getSchedulingInfo() {
+    return schedulingInfo;
+}
+
+/*
+* This function formats a time as (MM/DD/YYYY HH:MM:SS AM/PM). Consoles keep
+* the raw time and format it only when it is displayed.
 *
-* @return buffer - the current time in the format (MM/DD/YYYY HH:MM:SS AM/PM)
+* @param time - the time to format
+* @return buffer - the time in the format (MM/DD/YYYY HH:MM:SS AM/PM)
 */
-std::string AConsole::getCurrentTime() {
-    std::time_t now = std::time(0);
+std::string AConsole::formatTime(std::time_t time) {
     std::tm localTime;
-    localtime_s(&localTime, &now);
+    toLocalTime(time, localTime);
     char buffer[50];
     std::strftime(buffer, sizeof(buffer), "(%m/%d/%Y %H:%M:%S%p)", &localTime);
     return buffer;
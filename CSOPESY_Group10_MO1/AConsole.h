@@ -3,28 +3,100 @@
 #include <ctime>
 #include <vector>
 #include <iostream>
+#include <chrono>
+#include <atomic>
+#include "Program.h"
+#include "PagingManager.h"
+#include "CoreCounters.h"
 using namespace std;
 
 class AConsole {
+    public:
+        enum Status { RUNNING, WAITING, TERMINATED };
+
+        // A consistent view of the fields a core updates while running
+        struct Snapshot {
+            int instructionLine;
+            int instructionTotal;
+            int coreID;
+            Status status;
+        };
+
+        // Bookkeeping owned by the active SchedulerPolicy. Only touched while
+        // the scheduler holds processMutex.
+        struct SchedulingInfo {
+            int level = 0;
+            int64_t arrivalTime = 0;
+            int64_t readyTime = 0;
+            uint64_t vruntime = 0;
+        };
+
     private:
         int processID;
-        string name;
-        string timestamp;
-        int instructionLine;
-        int instructionTotal;
-        int coreID;
+        string name;                // empty when the name is derived from the PID
+        string timestamp;           // empty until first asked for, unless restored
+        time_t createdAt = 0;
+
+        // Written only by the core that currently owns the process and
+        // published through stateSequence, a seqlock that is odd while an
+        // update is in progress. Readers retry instead of blocking the core.
+        atomic<unsigned int> stateSequence{ 0 };
+        atomic<int> instructionLine;
+        atomic<int> instructionTotal;
+        atomic<int> coreID;
+        atomic<Status> status;
+
+        // The process body, compiled on first dispatch and released when the
+        // process finishes. Only the core that owns the process touches it.
+        Program program;
+        Program::State programState;
+        PagingManager::PageTable* pageTable = nullptr;
+        SchedulingInfo schedulingInfo;
+
         bool isActive;
-        
-    public:
-        enum Status { RUNNING, WAITING, TERMINATED };
-        Status status;
+        uint64_t delaySeed = 0;
+        uint32_t logSequence = 0;   // log records kept so far; only the owning core touches it
+        chrono::steady_clock::time_point enqueueTime;
+
+        // Steady-clock nanoseconds of the process's scheduling events, 0 until
+        // the event happens. Written only by the thread that owns the process.
+        int64_t arrivalNs = 0;
+        int64_t firstDispatchNs = 0;
+        int64_t lastDispatchNs = 0;
+        int64_t lastPreemptNs = 0;
+        int64_t finishedNs = 0;
+
+        // Links for the ProcessStateLists list this console is on
+        AConsole* listPrev = nullptr;
+        AConsole* listNext = nullptr;
+        int listIndex = -1;
+        friend class ProcessStateLists;
 
-        AConsole(const string& name, int instructionTotal);
+        unsigned int beginUpdate();
+        void endUpdate(unsigned int sequence);
 
-        void runProcess(int coreID, int quantum_cycles, int delaysPerExec);
+    public:
+        AConsole(int processID, const string& name, int instructionTotal);
+        AConsole(int processID, const string& name, int instructionTotal, const string& timestamp);
+        AConsole(int processID, int instructionTotal, time_t createdAt);
+
+        void runProcess(int coreID, int quantum_cycles, int delaysPerExec, CoreCounters* counters = nullptr);
+        void dispatch(int coreID);
+        bool executeInstruction();
+        int getSleepTicks() const;
+        void preempt();
+        Snapshot snapshot() const;
+        void restoreState(int instructionLine, int coreID, Status status);
 
         string getName() const;
+        const string& getStoredName() const;
+        bool hasGeneratedName() const;
+        bool hasName(const string& name) const;
+        static string nameForPid(int pid);
+        static int pidForName(const string& name);
         string getTimestamp() const;
+        time_t getCreatedAt() const;
+        const string& getRestoredTimestamp() const;
         int getInstructionLine() const;
         void setInstructionLine(int instructionLine);
         int getInstructionTotal() const;
@@ -33,9 +105,20 @@ class AConsole {
         int getCoreID() const; 
         int getProcessID() const;
         void setProcessID(int id);
+        uint64_t getDelaySeed() const;
+        void setDelaySeed(uint64_t seed);
         bool getIsActive() const; 
         void setIsActive(bool active);
-
-    private:
-        static string getCurrentTime();
+        void markEnqueued();
+        void markEnqueued(chrono::steady_clock::time_point now);
+        chrono::steady_clock::time_point getEnqueueTime() const;
+        void markDispatched(int64_t nowNs);
+        int64_t getArrivalNs() const;
+        int64_t getFirstDispatchNs() const;
+        int64_t getLastDispatchNs() const;
+        int64_t getLastPreemptNs() const;
+        int64_t getFinishedNs() const;
+        static int64_t monotonicNs();
+        SchedulingInfo& getSchedulingInfo();
+        static string formatTime(time_t time);
 };
@@ -0,0 +1,160 @@
+#include "BackingStore.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const size_t INITIAL_SLOTS = 1024;
+
+BackingStore::~BackingStore() {
+    close();
+}
+
+/*
+* This function creates (or truncates) the swap file and maps its first slots
+*
+* @param fileName - the swap file
+* @param pageSize - the size of one slot, in bytes
+* @return true if the file could be created and mapped, false otherwise
+*/
+bool BackingStore::open(const string& fileName, size_t pageSize) {
+    close();
+    this->pageSize = pageSize;
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        fileHandle = nullptr;
+        return false;
+    }
+#else
+    fileDescriptor = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+#endif
+
+    if (!map(INITIAL_SLOTS)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/*
+* This function unmaps and closes the swap file
+*/
+void BackingStore::close() {
+    unmap();
+#ifdef _WIN32
+    if (fileHandle != nullptr) CloseHandle(fileHandle);
+    fileHandle = nullptr;
+#else
+    if (fileDescriptor >= 0) ::close(fileDescriptor);
+    fileDescriptor = -1;
+#endif
+    capacity = 0;
+    nextSlot = 0;
+    freeSlots.clear();
+}
+
+/*
+* This function grows the file to hold the given number of slots and maps
+* all of it. The new mapping is made before the old one is removed, so if the
+* file cannot be grown or mapped the old mapping and its pages are kept.
+* Pointers returned by slot() before a successful call are invalidated.
+*
+* @param slots - the new number of slots
+* @return true if the file was mapped at the new size, false if it was left as it was
+*/
+bool BackingStore::map(size_t slots) {
+    size_t bytes = slots * pageSize;
+
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    size.QuadPart = (LONGLONG)bytes;
+    void* newMappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+    if (newMappingHandle == nullptr) return false;
+    char* newData = static_cast<char*>(MapViewOfFile(newMappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, bytes));
+    if (newData == nullptr) {
+        CloseHandle(newMappingHandle);
+        return false;
+    }
+    unmap();
+    mappingHandle = newMappingHandle;
+#else
+    if (ftruncate(fileDescriptor, (off_t)bytes) != 0) return false;
+    void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if (mapping == MAP_FAILED) return false;
+    char* newData = static_cast<char*>(mapping);
+    unmap();
+#endif
+
+    data = newData;
+    capacity = slots;
+    return true;
+}
+
+/*
+* This function removes the current mapping, if any
+*/
+void BackingStore::unmap() {
+#ifdef _WIN32
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+    mappingHandle = nullptr;
+#else
+    if (data != nullptr) munmap(data, capacity * pageSize);
+#endif
+    data = nullptr;
+}
+
+/*
+* This function reserves a slot for a page, growing the file when it is full
+*
+* @return the slot index, or -1 if the file could not be grown
+*/
+int64_t BackingStore::allocateSlot() {
+    if (!freeSlots.empty()) {
+        int64_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+    if (nextSlot == capacity && !map(capacity * 2)) {
+        return -1;
+    }
+    return (int64_t)nextSlot++;
+}
+
+/*
+* This function returns a slot to the free list
+*
+* @param slot - the slot to free
+*/
+void BackingStore::freeSlot(int64_t slot) {
+    freeSlots.push_back(slot);
+}
+
+/*
+* This function returns the bytes of a slot inside the mapping
+*
+* @param slot - the slot index
+* @return a pointer to pageSize bytes
+*/
+char* BackingStore::slot(int64_t slot) const {
+    return data + slot * pageSize;
+}
+
+size_t BackingStore::slotsInUse() const {
+    return nextSlot - freeSlots.size();
+}
+
+size_t BackingStore::fileSize() const {
+    return capacity * pageSize;
+}
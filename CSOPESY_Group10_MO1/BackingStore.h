@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+/*
+* The swap file for evicted pages.
+*
+* The file is divided into page-sized slots and memory-mapped, so paging out
+* is a memcpy into the mapping and the kernel decides when the bytes reach the
+* disk. Freed slots are reused; when every slot is taken the file is doubled
+* and mapped again. The store is not synchronized, its owner must serialize
+* calls.
+*/
+class BackingStore {
+private:
+    char* data = nullptr;
+    size_t pageSize = 0;
+    size_t capacity = 0;
+    size_t nextSlot = 0;
+    vector<int64_t> freeSlots;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+
+    bool map(size_t slots);
+    void unmap();
+
+public:
+    BackingStore() = default;
+    BackingStore(const BackingStore&) = delete;
+    BackingStore& operator=(const BackingStore&) = delete;
+    ~BackingStore();
+
+    bool open(const string& fileName, size_t pageSize);
+    void close();
+    int64_t allocateSlot();
+    void freeSlot(int64_t slot);
+    char* slot(int64_t slot) const;
+    size_t slotsInUse() const;
+    size_t fileSize() const;
+};
@@ -0,0 +1,236 @@
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+#include "Checkpoint.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+* This function writes a checkpoint of the given processes
+*
+* @param fileName - the checkpoint file
+* @param config - a header with the configuration fields filled in
+* @param traceFile - the workload trace file setting
+* @param processes - the processes, in the order they should be restored
+* @return true if the checkpoint was written, false otherwise
+*/
+bool CheckpointWriter::save(const string& fileName, const CheckpointHeader& config, const string& traceFile, const vector<CheckpointProcess>& processes) {
+    CheckpointHeader header = config;
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.headerSize = sizeof(CheckpointHeader);
+    header.processCount = processes.size();
+    header.recordsOffset = sizeof(CheckpointHeader);
+    header.stringsOffset = header.recordsOffset + processes.size() * sizeof(CheckpointRecord);
+
+    vector<CheckpointRecord> records(processes.size());
+    string strings = traceFile;
+    header.traceFileOffset = 0;
+    header.traceFileLength = (uint32_t)traceFile.size();
+    for (size_t i = 0; i < processes.size(); ++i) {
+        const CheckpointProcess& process = processes[i];
+        CheckpointRecord& record = records[i];
+
+        record = {};
+        record.processID = process.processID;
+        record.instructionLine = process.state.instructionLine;
+        record.instructionTotal = process.state.instructionTotal;
+        record.coreID = process.state.coreID;
+        record.status = process.state.status;
+        record.delaySeed = process.delaySeed;
+        record.nameOffset = strings.size();
+        record.nameLength = (uint32_t)process.name.size();
+        strings += process.name;
+        record.timestampOffset = strings.size();
+        record.timestampLength = (uint32_t)process.timestamp.size();
+        strings += process.timestamp;
+    }
+    header.stringsSize = strings.size();
+
+    string tempName = fileName + ".tmp";
+    {
+        ofstream outFile(tempName, ios::out | ios::trunc | ios::binary);
+        if (!outFile.is_open()) return false;
+
+        outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        outFile.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(CheckpointRecord));
+        outFile.write(strings.data(), strings.size());
+        if (!outFile) return false;
+    }
+
+    error_code error;
+    filesystem::rename(tempName, fileName, error);
+    return !error;
+}
+
+CheckpointReader::~CheckpointReader() {
+    close();
+}
+
+/*
+* This function unmaps the file, if one is open
+*/
+void CheckpointReader::close() {
+#ifdef _WIN32
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+    if (fileHandle != nullptr && fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (data != nullptr) munmap(const_cast<char*>(data), size);
+    if (fileDescriptor >= 0) ::close(fileDescriptor);
+    fileDescriptor = -1;
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+/*
+* This function maps a checkpoint file and validates its header, bounds and records
+*
+* @param fileName - the checkpoint file
+* @param error - receives a description of the problem if the file is rejected
+* @return true if the checkpoint can be read, false otherwise
+*/
+bool CheckpointReader::open(const string& fileName, string& error) {
+    close();
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        error = "could not open file";
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(fileHandle, &fileSize);
+    size = (size_t)fileSize.QuadPart;
+    if (size >= sizeof(CheckpointHeader)) {
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle != nullptr) {
+            data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+#else
+    fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        error = "could not open file";
+        return false;
+    }
+    struct stat fileStat;
+    fstat(fileDescriptor, &fileStat);
+    size = (size_t)fileStat.st_size;
+    if (size >= sizeof(CheckpointHeader)) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (mapping != MAP_FAILED) {
+            data = static_cast<const char*>(mapping);
+        }
+    }
+#endif
+
+    if (data == nullptr) {
+        error = "file is too small or could not be mapped";
+        close();
+        return false;
+    }
+
+    const CheckpointHeader& head = header();
+    if (memcmp(head.magic, CHECKPOINT_MAGIC, sizeof(head.magic)) != 0) {
+        error = "not a checkpoint file";
+    }
+    else if (head.version != CHECKPOINT_VERSION || head.headerSize != sizeof(CheckpointHeader)) {
+        error = "unsupported checkpoint version " + to_string(head.version);
+    }
+    // Offsets come from the file, so every bound is checked by subtraction
+    // or division rather than by a sum that could wrap around
+    else if (head.recordsOffset < sizeof(CheckpointHeader) || head.recordsOffset % alignof(CheckpointRecord) != 0
+        || head.stringsOffset < head.recordsOffset || head.stringsOffset > size
+        || head.processCount > (head.stringsOffset - head.recordsOffset) / sizeof(CheckpointRecord)
+        || head.stringsSize > size - head.stringsOffset
+        || head.traceFileOffset > head.stringsSize || head.traceFileLength > head.stringsSize - head.traceFileOffset) {
+        error = "checkpoint is truncated";
+    }
+    else if (head.mlfqQuantumCount < 0 || head.mlfqQuantumCount > CHECKPOINT_MAX_MLFQ_LEVELS) {
+        error = "invalid mlfq-quantum count " + to_string(head.mlfqQuantumCount);
+    }
+    else if (head.nextProcessId < 1) {
+        error = "invalid next process ID " + to_string(head.nextProcessId);
+    }
+    else {
+        // Check every record before the caller creates any process from them
+        for (uint64_t i = 0; i < head.processCount; ++i) {
+            const CheckpointRecord& entry = record(i);
+            if (entry.processID < 1 || entry.processID >= head.nextProcessId
+                || entry.instructionTotal < 1 || entry.instructionLine < 0 || entry.instructionLine > entry.instructionTotal
+                || entry.status < AConsole::RUNNING || entry.status > AConsole::TERMINATED
+                || entry.coreID < -1 || entry.coreID >= head.numCpu) {
+                error = "record " + to_string(i) + " is invalid";
+                close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    close();
+    return false;
+}
+
+/*
+* This function returns the checkpoint header
+*
+* @return the header at the start of the mapping
+*/
+const CheckpointHeader& CheckpointReader::header() const {
+    return *reinterpret_cast<const CheckpointHeader*>(data);
+}
+
+/*
+* This function returns a process record
+*
+* @param index - the record index, in restore order
+* @return the record, read in place from the mapping
+*/
+const CheckpointRecord& CheckpointReader::record(size_t index) const {
+    return reinterpret_cast<const CheckpointRecord*>(data + header().recordsOffset)[index];
+}
+
+/*
+* This function returns a record's process name
+*
+* @param record - the record
+* @return the name, or an empty string if it lies outside the string data
+*/
+string CheckpointReader::name(const CheckpointRecord& record) const {
+    if (record.nameOffset > header().stringsSize || record.nameLength > header().stringsSize - record.nameOffset) return "";
+    return string(data + header().stringsOffset + record.nameOffset, record.nameLength);
+}
+
+/*
+* This function returns a record's creation timestamp
+*
+* @param record - the record
+* @return the timestamp, or an empty string if it lies outside the string data
+*/
+string CheckpointReader::timestamp(const CheckpointRecord& record) const {
+    if (record.timestampOffset > header().stringsSize || record.timestampLength > header().stringsSize - record.timestampOffset) return "";
+    return string(data + header().stringsOffset + record.timestampOffset, record.timestampLength);
+}
+
+/*
+* This function returns the workload trace file setting
+*
+* @return the trace file, checked against the string data when the file was opened
+*/
+string CheckpointReader::traceFile() const {
+    return string(data + header().stringsOffset + header().traceFileOffset, header().traceFileLength);
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "AConsole.h"
+
+using namespace std;
+
+/*
+* On-disk layout of a scheduler checkpoint.
+*
+*   CheckpointHeader
+*   CheckpointRecord[processCount]
+*   string data (trace file, names and timestamps, not null terminated)
+*
+* Every field is fixed width and naturally aligned, so a restore maps the
+* file and reads the records in place without parsing. Records are stored in
+* dispatch order: processes that were running (by core), then the waiting
+* queue from front to back, then finished processes from oldest to newest.
+*/
+const char CHECKPOINT_MAGIC[8] = { 'C', 'S', 'O', 'P', 'C', 'K', 'P', 'T' };
+const uint32_t CHECKPOINT_VERSION = 2;
+const int CHECKPOINT_MAX_MLFQ_LEVELS = 64;
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+
+    // Configuration the snapshot was taken with
+    int32_t numCpu;
+    int32_t quantumCycles;
+    int32_t batchProcessFreq;
+    int32_t batchProcessCount;
+    int32_t minIns;
+    int32_t maxIns;
+    int32_t delaysPerExec;
+    int32_t maxFinished;
+    int32_t nextProcessId;
+    int32_t mlfqLevels;
+    int32_t mlfqBoost;
+    int32_t fairLatency;
+    int32_t fairMinGranularity;
+    int32_t mlfqQuantumCount;
+    int32_t mlfqQuantums[CHECKPOINT_MAX_MLFQ_LEVELS];
+    uint64_t maxOverallMem;
+    uint64_t memPerProc;
+    uint64_t memPerFrame;
+    uint64_t workloadSeed;
+    char scheduler[16];
+    char clockMode[16];
+    char memAlloc[16];
+    char coreAffinity[16];
+    char processLog[16];
+    char workloadTrace[16];
+
+    uint64_t processCount;
+    uint64_t recordsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t traceFileOffset;
+    uint32_t traceFileLength;
+    uint32_t reserved;
+};
+
+struct CheckpointRecord {
+    int32_t processID;
+    int32_t instructionLine;
+    int32_t instructionTotal;
+    int32_t coreID;
+    int32_t status;
+    uint32_t nameLength;
+    uint64_t nameOffset;
+    uint32_t timestampLength;
+    uint32_t reserved;
+    uint64_t timestampOffset;
+    uint64_t delaySeed;
+};
+
+// A process as handed to the checkpoint writer
+struct CheckpointProcess {
+    int processID;
+    string name;
+    string timestamp;
+    uint64_t delaySeed;
+    AConsole::Snapshot state;
+};
+
+/*
+* Writes a checkpoint file. The file is written to a temporary name and
+* renamed into place, so an interrupted checkpoint never replaces a good one.
+*/
+class CheckpointWriter {
+public:
+    static bool save(const string& fileName, const CheckpointHeader& config, const string& traceFile, const vector<CheckpointProcess>& processes);
+};
+
+/*
+* A read-only, memory-mapped view of a checkpoint file. Records and strings
+* are read straight out of the mapping.
+*/
+class CheckpointReader {
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+
+    void close();
+
+public:
+    CheckpointReader() = default;
+    CheckpointReader(const CheckpointReader&) = delete;
+    CheckpointReader& operator=(const CheckpointReader&) = delete;
+    ~CheckpointReader();
+
+    bool open(const string& fileName, string& error);
+    const CheckpointHeader& header() const;
+    const CheckpointRecord& record(size_t index) const;
+    string name(const CheckpointRecord& record) const;
+    string timestamp(const CheckpointRecord& record) const;
+    string traceFile() const;
+};
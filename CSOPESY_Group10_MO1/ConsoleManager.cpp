@@ -2,13 +2,21 @@
 #include <string>
 #include <vector>
 #include <utility>
-#include <format>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
-#include <random>
+#include <cstring>
+#include <algorithm>
 #include "ConsoleManager.h"
 #include "AConsole.h"
+#include "ReportWriter.h"
+#include "Checkpoint.h"
+#include "ProcessLogger.h"
+#include "PagingManager.h"
+#include "MlfqPolicy.h"
+#include "FairPolicy.h"
+#include "RemainingTimePolicy.h"
+#include "Platform.h"
 
 using namespace std;
 
@@ -16,21 +24,74 @@ int num_cpu;
 string scheduler;
 int quantum_cycles;
 int batch_process_freq;
+int batch_process_count = 1;
 int min_ins;
 int max_ins;
 int delays_per_exec;
+string clock_mode = "real";
+int max_finished = 0;
+string process_log = "off";
+uint64_t max_overall_mem = 0;
+uint64_t mem_per_proc = 0;
+string mem_alloc = "first-fit";
+uint64_t mem_per_frame = 0;
+int mlfq_levels = 3;
+vector<int> mlfq_quantums;
+int mlfq_boost = 100;
+int fair_latency = 0;
+int fair_min_granularity = 1;
+string core_affinity = "off";
+uint64_t workload_seed = 0;
+string workload_trace = "off";
+string trace_file = "workload.trace";
 const uint64_t MAX_VALUE = 4294967296;
 
 bool scheduler_test_run = false;
 
-void ConsoleManager::initialize() {
+/*
+* This function loads the configuration and starts the cores
+*
+* @param configFile - the configuration file, config.txt by default
+*/
+void ConsoleManager::initialize(const string& configFile) {
 
-	readConfig("config.txt");
+	readConfig(configFile);
+    startCores();
+}
 
+/*
+* This function sets up the CPU cores from the loaded configuration and
+* starts the scheduler
+*/
+void ConsoleManager::startCores() {
     coreCount = num_cpu;
     availableCores = num_cpu;
 
-    cpuCores = vector<bool>(num_cpu, false);
+    cpuCores = vector<atomic<bool>>(num_cpu);
+    workload.configure(workload_seed, workload_trace == "record" ? Workload::RECORD : workload_trace == "replay" ? Workload::REPLAY : Workload::GENERATE,
+                       trace_file, min_ins, max_ins);
+    coreCounters = make_unique<CoreCounters[]>(num_cpu);
+    // With mem-per-frame set, memory is demand paged instead of handed out
+    // in contiguous blocks, so admission is no longer gated on it
+    if (max_overall_mem > 0 && mem_per_frame > 0) {
+        if (!pagingManager.configure(max_overall_mem, (uint32_t)mem_per_frame, mem_per_proc, "backing-store.bin")) {
+            cerr << "Error: Could not create the backing store, paging is disabled.\n";
+        }
+        memory.configure(0, mem_per_proc, MemoryManager::FIRST_FIT);
+    }
+    else {
+        memory.configure(max_overall_mem, mem_per_proc, mem_alloc == "best-fit" ? MemoryManager::BEST_FIT : MemoryManager::FIRST_FIT);
+    }
+
+    if (process_log != "off") {
+        // The writer resolves a process name the first time it sees the
+        // process; reapMutex keeps the console alive while it is read
+        processLogger.start(num_cpu, process_log == "all" ? ProcessLogger::ALL : ProcessLogger::PRINT, "logs", [this](int pid) {
+            lock_guard<mutex> lock(reapMutex);
+            AConsole* console = consoles.findByPid(pid);
+            return console != nullptr ? console->getName() : "process" + to_string(pid);
+        });
+    }
     startScheduler();
 }
 
@@ -43,9 +104,20 @@ void ConsoleManager::readConfig(const string& filename) {
         cerr << "Error: Could not open config file.\n";
         return;
     }
+    applyConfig(configFile);
+}
 
+/*
+* This function parses "key value" configuration lines and applies them,
+* range checking every value. config.txt and restored checkpoints both go
+* through here.
+*
+* @param config - the configuration lines
+* @return true if every value was valid, false at the first invalid one
+*/
+bool ConsoleManager::applyConfig(istream& config) {
     string line;
-    while (getline(configFile, line)) {
+    while (getline(config, line)) {
         istringstream iss(line);
         string key;
         if (!(iss >> key)) continue;
@@ -54,61 +126,220 @@ void ConsoleManager::readConfig(const string& filename) {
             iss >> num_cpu;
             if (num_cpu < 1 || num_cpu > 128) {
                 cerr << "Error: Invalid num-cpu value: " << num_cpu << ". Must be in range [1, 128].\n";
-                return;
+                return false;
             }
         }
         else if (key == "scheduler") {
             string value;
             iss >> quoted(value);  // Use std::quoted to handle quotes
             scheduler = value;  // Assign the stripped value
-            if (scheduler != "fcfs" && scheduler != "rr") {
-                cerr << "Error: Invalid scheduler value: '" << scheduler << "'. Must be 'fcfs' or 'rr'.\n";
-                return;
+            if (scheduler != "fcfs" && scheduler != "rr" && scheduler != "mlfq" && scheduler != "fair" && scheduler != "sjf" && scheduler != "srtf") {
+                cerr << "Error: Invalid scheduler value: '" << scheduler << "'. Must be 'fcfs', 'rr', 'mlfq', 'fair', 'sjf' or 'srtf'.\n";
+                return false;
             }
         }
         else if (key == "quantum-cycles") {
             iss >> quantum_cycles;
             if (quantum_cycles < 1 || quantum_cycles > MAX_VALUE) {
                 cerr << "Error: Invalid quantum-cycles value: " << quantum_cycles << ". Must be in range [1, " << MAX_VALUE << "].\n";
-                return;
+                return false;
             }
         }
         else if (key == "batch-process-freq") {
             iss >> batch_process_freq;
             if (batch_process_freq < 1 || batch_process_freq > MAX_VALUE) {
                 cerr << "Error: Invalid batch-process-freq value: " << batch_process_freq << ". Must be in range [1, " << MAX_VALUE << "].\n";
-                return;
+                return false;
             }
         }
         else if (key == "min-ins") {
             iss >> min_ins;
             if (min_ins < 1 || min_ins > MAX_VALUE) {
                 cerr << "Error: Invalid min-ins value: " << min_ins << ". Must be in range [1, " << MAX_VALUE << "].\n";
-                return;
+                return false;
             }
         }
         else if (key == "max-ins") {
             iss >> max_ins;
             if (max_ins < 1 || max_ins > MAX_VALUE) {
                 cerr << "Error: Invalid max-ins value: " << max_ins << ". Must be in range [1, " << MAX_VALUE << "].\n";
-                return;
+                return false;
             }
         }
         else if (key == "delays-per-exec") {
             iss >> delays_per_exec;
             if (delays_per_exec < 0 || delays_per_exec > MAX_VALUE) {
                 cerr << "Error: Invalid delays-per-exec value: " << delays_per_exec << ". Must be in range [0, " << MAX_VALUE << "].\n";
-                return;
+                return false;
+            }
+        }
+        else if (key == "max-finished") {
+            iss >> max_finished;
+            if (max_finished < 0 || max_finished > MAX_VALUE) {
+                cerr << "Error: Invalid max-finished value: " << max_finished << ". Must be in range [0, " << MAX_VALUE << "].\n";
+                return false;
+            }
+        }
+        else if (key == "clock-mode") {
+            string value;
+            iss >> quoted(value);
+            clock_mode = value;
+            if (clock_mode != "real" && clock_mode != "virtual") {
+                cerr << "Error: Invalid clock-mode value: '" << clock_mode << "'. Must be 'real' or 'virtual'.\n";
+                return false;
+            }
+        }
+        else if (key == "core-affinity") {
+            string value;
+            iss >> quoted(value);
+            core_affinity = value;
+            if (core_affinity != "on" && core_affinity != "off") {
+                cerr << "Error: Invalid core-affinity value: '" << core_affinity << "'. Must be 'on' or 'off'.\n";
+                return false;
+            }
+        }
+        else if (key == "process-log") {
+            string value;
+            iss >> quoted(value);
+            process_log = value;
+            if (process_log != "off" && process_log != "print" && process_log != "all") {
+                cerr << "Error: Invalid process-log value: '" << process_log << "'. Must be 'off', 'print' or 'all'.\n";
+                return false;
+            }
+        }
+        else if (key == "max-overall-mem") {
+            iss >> max_overall_mem;
+            if (max_overall_mem > MAX_VALUE) {
+                cerr << "Error: Invalid max-overall-mem value: " << max_overall_mem << ". Must be in range [0, " << MAX_VALUE << "].\n";
+                return false;
+            }
+        }
+        else if (key == "mem-per-proc") {
+            iss >> mem_per_proc;
+            if (mem_per_proc < 1 || mem_per_proc > MAX_VALUE) {
+                cerr << "Error: Invalid mem-per-proc value: " << mem_per_proc << ". Must be in range [1, " << MAX_VALUE << "].\n";
+                return false;
+            }
+        }
+        else if (key == "mem-alloc") {
+            string value;
+            iss >> quoted(value);
+            mem_alloc = value;
+            if (mem_alloc != "first-fit" && mem_alloc != "best-fit") {
+                cerr << "Error: Invalid mem-alloc value: '" << mem_alloc << "'. Must be 'first-fit' or 'best-fit'.\n";
+                return false;
+            }
+        }
+        else if (key == "mem-per-frame") {
+            iss >> mem_per_frame;
+            if (mem_per_frame > MAX_VALUE) {
+                cerr << "Error: Invalid mem-per-frame value: " << mem_per_frame << ". Must be in range [0, " << MAX_VALUE << "].\n";
+                return false;
+            }
+        }
+        else if (key == "mlfq-levels") {
+            iss >> mlfq_levels;
+            if (mlfq_levels < 1 || mlfq_levels > MlfqPolicy::MAX_LEVELS) {
+                cerr << "Error: Invalid mlfq-levels value: " << mlfq_levels << ". Must be in range [1, " << MlfqPolicy::MAX_LEVELS << "].\n";
+                return false;
+            }
+        }
+        else if (key == "mlfq-quantum") {
+            // One quantum per level, highest priority first
+            mlfq_quantums.clear();
+            int value;
+            while (iss >> value) {
+                if (value < 1) {
+                    cerr << "Error: Invalid mlfq-quantum value: " << value << ". Must be at least 1.\n";
+                    return false;
+                }
+                mlfq_quantums.push_back(value);
+            }
+        }
+        else if (key == "mlfq-boost") {
+            iss >> mlfq_boost;
+            if (mlfq_boost < 0) {
+                cerr << "Error: Invalid mlfq-boost value: " << mlfq_boost << ". Must be at least 0.\n";
+                return false;
+            }
+        }
+        else if (key == "fair-latency") {
+            iss >> fair_latency;
+            if (fair_latency < 1) {
+                cerr << "Error: Invalid fair-latency value: " << fair_latency << ". Must be at least 1.\n";
+                return false;
+            }
+        }
+        else if (key == "fair-min-granularity") {
+            iss >> fair_min_granularity;
+            if (fair_min_granularity < 1) {
+                cerr << "Error: Invalid fair-min-granularity value: " << fair_min_granularity << ". Must be at least 1.\n";
+                return false;
+            }
+        }
+        else if (key == "batch-process-count") {
+            // Processes scheduler-test admits together on each batch tick
+            iss >> batch_process_count;
+            if (batch_process_count < 1 || batch_process_count > (1 << 20)) {
+                cerr << "Error: Invalid batch-process-count value: " << batch_process_count << ". Must be in range [1, " << (1 << 20) << "].\n";
+                batch_process_count = 1;
+                return false;
+            }
+        }
+        else if (key == "seed") {
+            // 0 picks a new seed every run
+            if (!(iss >> workload_seed)) {
+                cerr << "Error: Invalid seed value. Must be an integer in range [0, " << UINT64_MAX << "].\n";
+                workload_seed = 0;
+                return false;
+            }
+        }
+        else if (key == "workload-trace") {
+            string value;
+            iss >> quoted(value);
+            workload_trace = value;
+            if (workload_trace != "off" && workload_trace != "record" && workload_trace != "replay") {
+                cerr << "Error: Invalid workload-trace value: '" << workload_trace << "'. Must be 'off', 'record' or 'replay'.\n";
+                return false;
+            }
+        }
+        else if (key == "trace-file") {
+            string value;
+            iss >> quoted(value);
+            trace_file = value;
+            if (trace_file.empty()) {
+                cerr << "Error: Invalid trace-file value. Must not be empty.\n";
+                trace_file = "workload.trace";
+                return false;
             }
         }
         else {
             cerr << "Error: Unknown parameter in config file: " << key << endl;
-            return;
+            return false;
         }
     }
+
+    // Without paging, a process that can never fit would wait forever
+    if (max_overall_mem > 0 && (mem_per_proc < 1 || (mem_per_frame == 0 && mem_per_proc > max_overall_mem))) {
+        cerr << "Error: Invalid mem-per-proc value: " << mem_per_proc << ". Must be in range [1, max-overall-mem].\n";
+        max_overall_mem = 0;
+        return false;
+    }
+    if (max_overall_mem > 0 && mem_per_frame > max_overall_mem) {
+        cerr << "Error: Invalid mem-per-frame value: " << mem_per_frame << ". Must be in range [0, max-overall-mem].\n";
+        mem_per_frame = 0;
+        return false;
+    }
+    if (mlfq_quantums.size() > (size_t)mlfq_levels) {
+        cerr << "Error: Invalid mlfq-quantum value: " << mlfq_quantums.size() << " quantums given. Must not exceed mlfq-levels (" << mlfq_levels << ").\n";
+        return false;
+    }
+    if (min_ins > max_ins) {
+        cerr << "Error: Invalid min-ins value: " << min_ins << ". Must not exceed max-ins (" << max_ins << ").\n";
+        return false;
+    }
     //cout << "Configuration successfully loaded.\n";
-    configFile.close();
-    return;
+    return true;
 }
 
 void ConsoleManager::testConfig() {
@@ -117,9 +348,25 @@ void ConsoleManager::testConfig() {
     cout << "scheduler: " << scheduler << endl;
     cout << "quantum-cycles: " << quantum_cycles << endl;
     cout << "batch-process-freq: " << batch_process_freq << endl;
+    cout << "batch-process-count: " << batch_process_count << endl;
     cout << "min-ins: " << min_ins << endl;
     cout << "max-ins: " << max_ins << endl;
     cout << "delays-per-exec: " << delays_per_exec << endl;
+    cout << "clock-mode: " << clock_mode << endl;
+    cout << "core-affinity: " << core_affinity << endl;
+    cout << "max-finished: " << max_finished << endl;
+    cout << "process-log: " << process_log << endl;
+    cout << "max-overall-mem: " << max_overall_mem << endl;
+    cout << "mem-per-proc: " << mem_per_proc << endl;
+    cout << "mem-alloc: " << mem_alloc << endl;
+    cout << "mem-per-frame: " << mem_per_frame << endl;
+    cout << "mlfq-levels: " << mlfq_levels << endl;
+    cout << "mlfq-boost: " << mlfq_boost << endl;
+    cout << "fair-latency: " << fair_latency << endl;
+    cout << "fair-min-granularity: " << fair_min_granularity << endl;
+    cout << "seed: " << workload_seed << endl;
+    cout << "workload-trace: " << workload_trace << endl;
+    cout << "trace-file: " << trace_file << endl;
 }
 
 /*
@@ -128,37 +375,58 @@ void ConsoleManager::testConfig() {
 * @param name - the name of the console
 */
 void ConsoleManager::addConsole(const string& name, bool fromScreenCommand = false) {
-    lock_guard<mutex> lock(processMutex);
-
-    // Check if the console name already exists in the map
-    if (consoles.find(name) != consoles.end()) {
+    // Check if the console name already exists in the process table
+    if (consoles.find(name) != nullptr) {
         cout << "Console \"" << name << "\" already exists." << endl;
         return;
     }
 
-    // Create a unique process ID for the new console
-    static int nextId = 1;
-    int processId = nextId++;  // Generate the next process ID
-
-	// Generate a random number of instructions between min_ins and max_ins
-	random_device rd;
-	knuth_b knuth_gen(rd());
-	uniform_int_distribution<> dist(min_ins, max_ins);
-	int maxInstructions = dist(knuth_gen);
-
+    // Draw the number of instructions between min_ins and max_ins and the
+    // delay seed from this thread's generator
+    admitConsole(name, workload.next(), fromScreenCommand);
+}
 
-    // Create a new console with the provided name and max instructions
-    AConsole* newConsole = new AConsole(name, maxInstructions);
+/*
+* This function creates a console for an arrival and hands it to the scheduler
+*
+* @param name - the name of the console
+* @param arrival - the console's instruction count and delay seed
+* @param fromScreenCommand - true to display the console once it is created
+*/
+void ConsoleManager::admitConsole(const string& name, const Workload::Arrival& arrival, bool fromScreenCommand) {
+    // Create a unique process ID for the new console
+    int processId = nextProcessId++;  // Generate the next process ID
 
-    // Set the process ID using the setProcessID function
-    newConsole->setProcessID(processId);  // Ensure the process ID is properly set
+    // Create a new console with the process ID, provided name and max instructions
+    AConsole* newConsole = consolePool.create(processId, name, arrival.instructions);
+    newConsole->setDelaySeed(arrival.delaySeed);
 
     // Initialize additional details such as starting at instruction line 0
     newConsole->setInstructionLine(0);  // Start at instruction line 0
 
-    // Add the new console to the map and the waiting queue
-    waitingQueue.push(newConsole);
-    consoles[name] = newConsole;
+    // Add the new console to the process table
+    if (!consoles.insert(newConsole)) {
+        cout << "Console \"" << name << "\" already exists." << endl;
+        consolePool.destroy(newConsole);
+        return;
+    }
+    stateLists.move(newConsole, AConsole::WAITING);
+
+    // The process table and waiting queue have their own synchronization, so
+    // admitting a console never takes processMutex
+    newConsole->markEnqueued();
+    if (overflowCount.load(memory_order_acquire) > 0 || !waitingQueue.tryPush(newConsole)) {
+        // No core has seen the console yet, so it can be taken back out
+        {
+            lock_guard<mutex> lock(reapMutex);
+            consoles.remove(processId);
+            stateLists.remove(newConsole);
+            consolePool.destroy(newConsole);
+        }
+        cerr << "Error: waiting queue is full, console \"" << name << "\" was not created.\n";
+        return;
+    }
+    notifyScheduler();
 
     // Check if the console was created using the screen -s command
     if (fromScreenCommand) {
@@ -167,6 +435,88 @@ void ConsoleManager::addConsole(const string& name, bool fromScreenCommand = fal
     }
 }
 
+/*
+* This function adds a batch of consoles named after their process IDs, as
+* many of count as the waiting queue has room for
+*
+* @param count - the number of consoles to add
+* @return the number of consoles added
+*/
+size_t ConsoleManager::addConsoles(size_t count) {
+    count = min(count, admissionRoom());
+    vector<Workload::Arrival> arrivals(count);
+    workload.nextBatch(arrivals.data(), count);
+    return admitBatch(arrivals.data(), count);
+}
+
+/*
+* This function returns how many consoles can be admitted at once. A slot per
+* core is held back so a process a core hands back to the waiting queue
+* always fits.
+*
+* @return the number of free waiting queue slots to admit into
+*/
+size_t ConsoleManager::admissionRoom() const {
+    // Arrivals must not pass processes already waiting on the overflow list
+    if (overflowCount.load(memory_order_acquire) > 0) return 0;
+
+    size_t reserved = waitingQueue.sizeApprox() + coreCount;
+    return reserved < waitingQueue.capacity() ? waitingQueue.capacity() - reserved : 0;
+}
+
+/*
+* This function admits a batch of arrivals in one pass: one block of process
+* IDs, one trip to the pool, the process table and the state lists, and one
+* publication to the waiting queue. The consoles have no stored names, so
+* none are formatted or hashed; getName derives them from the process ID.
+*
+* @param arrivals - the arrivals' instruction counts and delay seeds
+* @param count - the number of arrivals
+* @return the number of consoles added
+*/
+size_t ConsoleManager::admitBatch(const Workload::Arrival* arrivals, size_t count) {
+    if (count == 0) return 0;
+
+    int firstProcessId = nextProcessId.fetch_add((int)count);
+    vector<int> instructionTotals(count);
+    for (size_t i = 0; i < count; ++i) {
+        instructionTotals[i] = arrivals[i].instructions;
+    }
+
+    vector<AConsole*> batch(count);
+    consolePool.createBatch(firstProcessId, instructionTotals.data(), count, time(0), batch.data());
+    auto now = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        batch[i]->setDelaySeed(arrivals[i].delaySeed);
+        batch[i]->markEnqueued(now);
+    }
+
+    // A PID whose name a user already gave to a console is skipped
+    size_t inserted = consoles.insertGenerated(batch.data(), count);
+    for (size_t i = inserted; i < count; ++i) {
+        consolePool.destroy(batch[i]);
+    }
+    stateLists.appendBatch(batch.data(), inserted, AConsole::WAITING);
+
+    size_t published = overflowCount.load(memory_order_acquire) > 0 ? 0 : waitingQueue.tryPushBulk(batch.data(), inserted);
+    if (published < inserted) {
+        // No core has seen the unpublished tail, so it can be taken back out
+        {
+            lock_guard<mutex> lock(reapMutex);
+            for (size_t i = published; i < inserted; ++i) {
+                consoles.remove(batch[i]->getProcessID());
+                stateLists.remove(batch[i]);
+                consolePool.destroy(batch[i]);
+            }
+        }
+        cerr << "Error: waiting queue is full, " << inserted - published << " consoles were not created.\n";
+    }
+    if (published > 0) {
+        notifyScheduler();
+    }
+    return published;
+}
+
 
 /*
 * This function displays the information of the specified console
@@ -174,11 +524,12 @@ void ConsoleManager::addConsole(const string& name, bool fromScreenCommand = fal
 * @param name - the name of the console
 */
 void ConsoleManager::displayConsole(const string& name) const {
+    lock_guard<mutex> lock(reapMutex);
+
     // Check if the console name exists in the map
-    auto it = consoles.find(name);
-    if (it != consoles.end()) {
-        AConsole* console = it->second;  // Get the pointer to the AConsole object
-        system("cls");  
+    AConsole* console = consoles.find(name);
+    if (console != nullptr) {
+        clearScreen();
 
         // Display console information
         cout << "Process: \"" << console->getName() << "\"" << endl;
@@ -208,14 +559,110 @@ void ConsoleManager::displayCPUInfo() {
 	cout << "CPU Utilization: " << fixed << setprecision(2) << cpuUsage << "%" << endl;
     cout << "Cores used: " << usedCores << endl;
     cout << "Cores available: " << availableCores << endl;
+    printProcessCounts(cout);
+    printMemoryStats(cout);
+    printDispatchStats(cout);
+    printSchedulerStats(cout);
+}
+
+/*
+* This function prints how many processes are in each state. The counts are
+* kept by the state lists, so this is O(1).
+*
+* @param out - the stream to print to
+*/
+void ConsoleManager::printProcessCounts(ostream& out) {
+    out << "Processes waiting: " << stateLists.count(AConsole::WAITING) << endl;
+    out << "Processes running: " << stateLists.count(AConsole::RUNNING) << endl;
+    out << "Processes finished: " << stateLists.count(AConsole::TERMINATED) << endl;
+}
+
+/*
+* This function prints the memory usage, the external fragmentation now and
+* per quantum, and how long allocations take
+*
+* @param out - the stream to print to
+*/
+void ConsoleManager::printMemoryStats(ostream& out) {
+    if (!memory.isEnabled()) return;
+
+    MemoryManager::Stats stats = memory.getStats();
+    out << "Memory used: " << stats.usedMemory << " / " << stats.totalMemory << " bytes" << endl;
+    out << "Processes in memory: " << stats.processesInMemory << endl;
+    out << "External fragmentation: " << stats.externalFragmentation << " bytes (" << stats.freeBlocks
+        << " free blocks, largest " << stats.largestFreeBlock << " bytes)" << endl;
+    if (stats.quantumSamples > 0) {
+        out << "Avg processes in memory per quantum: " << fixed << setprecision(2)
+            << stats.sampledProcessesTotal / (double)stats.quantumSamples << endl;
+        out << "Avg external fragmentation per quantum: " << fixed << setprecision(2)
+            << stats.sampledFragmentationTotal / (double)stats.quantumSamples << " bytes (max "
+            << stats.sampledFragmentationMax << ")" << endl;
+    }
+    out << "Allocations: " << stats.allocations << " (" << stats.failedAllocations << " deferred)" << endl;
+    if (stats.allocations > 0) {
+        out << "Avg allocation latency: " << fixed << setprecision(3) << stats.allocationLatencyTotalNs / (double)stats.allocations / 1e3 << " us" << endl;
+        out << "Max allocation latency: " << fixed << setprecision(3) << stats.allocationLatencyMaxNs / 1e3 << " us" << endl;
+    }
+}
+
+/*
+* This function prints the dispatch rate and the average and worst latency
+* from a process being enqueued to it starting to run on a core
+*
+* @param out - the stream to print to
+*/
+void ConsoleManager::printDispatchStats(ostream& out) {
+    long long dispatches = dispatchCount;
+    if (clock_mode == "virtual") {
+        out << "Virtual ticks: " << virtualTicks << endl;
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - schedulerStart).count();
+    if (elapsed > 0) {
+        out << "Dispatches/sec: " << fixed << setprecision(2) << dispatches / elapsed << endl;
+    }
+    if (dispatches > 0) {
+        out << "Avg dispatch latency: " << fixed << setprecision(3) << dispatchLatencyTotalNs / (double)dispatches / 1e6 << " ms" << endl;
+        out << "Max dispatch latency: " << fixed << setprecision(3) << dispatchLatencyMaxNs / 1e6 << " ms" << endl;
+        out << "Core migrations: " << migrationCount << " (" << fixed << setprecision(2)
+            << 100.0 * migrationCount / dispatches << "% of dispatches)" << endl;
+    }
+    affinity.printStats(out);
+    processLogger.printStats(out);
+    workload.printStats(out);
+}
+
+/*
+* This function copies the rows of every process in one state. Only pointers
+* and snapshots are copied while the state lists are locked, and reapMutex
+* keeps the consoles alive while the rest of each row is filled in after the
+* lock is released. Names derived from PIDs and timestamps are formatted by
+* whoever prints the rows, so listing never holds up the cores' state changes
+* for the length of the output.
+*
+* @param status - the state to copy
+* @return the rows, oldest transition first
+*/
+vector<ReportRow> ConsoleManager::copyRows(AConsole::Status status) const {
+    lock_guard<mutex> lock(reapMutex);
+
+    vector<pair<AConsole*, AConsole::Snapshot>> listed;
+    listed.reserve(stateLists.count(status));
+    stateLists.forEach(status, [&](AConsole* console) {
+        listed.emplace_back(console, console->snapshot());
+    });
+
+    vector<ReportRow> rows;
+    rows.reserve(listed.size());
+    for (const auto& [console, state] : listed) {
+        rows.push_back({ console->getProcessID(), console->getStoredName(), console->getCreatedAt(), console->getRestoredTimestamp(), state });
+    }
+    return rows;
 }
 
 /*
 * This function lists the status of all the consoles in the console screen
 */
 void ConsoleManager::listConsoles() {
-    lock_guard<mutex> lock(processMutex);
-
     displayCPUInfo();
 
     cout << "\n-----------------------------------------\n";
@@ -241,26 +688,23 @@ void ConsoleManager::listConsoles() {
     cout << "\n";
     if (!hasQueued) cout << "No queued consoles.\n"; */
 
+    vector<ReportRow> running = copyRows(AConsole::RUNNING);
+    vector<ReportRow> finished = copyRows(AConsole::TERMINATED);
+
     cout << "Running Processes:\n";
-    for (const auto& consolePair : consoles) {
-        AConsole* console = consolePair.second;  
+    for (const ReportRow& row : running) {
         // get all running consoles
-        if (console->getStatus() == AConsole::RUNNING) {
-            hasRunning = true;
-            cout << console->getName() + "\t" + console->getTimestamp() + "\tCore: " + to_string(console->getCoreID()) + "\t" + to_string(console->getInstructionLine()) + "/" + to_string(console->getInstructionTotal()) + "\n";
-        }
+        hasRunning = true;
+        cout << row.name() + "\t" + row.timestamp() + "\tCore: " + to_string(row.state.coreID) + "\t" + to_string(row.state.instructionLine) + "/" + to_string(row.state.instructionTotal) + "\n";
     }
     cout << "\n";
     if (!hasRunning) cout << "No running consoles.\n";
 
     cout << "Finished Processes:\n";
-    for (const auto& consolePair : consoles) {
-        AConsole* console = consolePair.second;  
+    for (const ReportRow& row : finished) {
         // get all finished consoles
-        if (console->getStatus() == AConsole::TERMINATED) {
-            hasFinished = true;
-            cout << console->getName() + "\t" + console->getTimestamp() + "\tFinished\t" + to_string(console->getInstructionLine()) + "/" + to_string(console->getInstructionTotal()) + "\n";
-        }
+        hasFinished = true;
+        cout << row.name() + "\t" + row.timestamp() + "\tFinished\t" + to_string(row.state.instructionLine) + "/" + to_string(row.state.instructionTotal) + "\n";
     }
     cout << "\n";
     if (!hasFinished) cout << "No terminated consoles.\n";
@@ -270,17 +714,10 @@ void ConsoleManager::listConsoles() {
 * This function prints the status of all the consoles as a .txt file
 */
 void ConsoleManager::reportUtil() {
-    lock_guard<mutex> lock(processMutex);
-
     string fileName = "console_report.txt";
-    ofstream outFile(fileName, ios::out | ios::trunc);
-
-    if (!outFile.is_open()) {
-        cerr << "Error: unable to open file for writing report details";
-        return;
-    }
+    ostringstream outFile;
 
-    // Start writing to the file
+    // Start writing the header
     outFile << "Console Report\n";
     outFile << "-----------------------------------------\n";
 
@@ -296,56 +733,37 @@ void ConsoleManager::reportUtil() {
     outFile << "CPU Utilization: " << fixed << setprecision(2) << cpuUsage << "%" << endl;
     outFile << "Cores used: " << usedCores << endl;
     outFile << "Cores available: " << availableCores << endl;
+    printCoreUtilization(outFile);
+    printProcessCounts(outFile);
+    printMemoryStats(outFile);
+    printDispatchStats(outFile);
+    printSchedulerStats(outFile);
+    printLatencyPercentiles(outFile);
 
     if (!hasConsoles()) {
         outFile << "No consoles to list.\n";
-        outFile.close();
+        ReportWriter::writeAsync(fileName, outFile.str());
         return;
     }
 
-    bool hasQueued = false;
-    bool hasRunning = false;
-    bool hasFinished = false;
-
- /* outFile << "Queued Processes:\n";
-    for (const auto& consolePair : consoles) {
-        AConsole* console = consolePair.second;
-        if (console->getStatus() == AConsole::WAITING) {
-            hasQueued = true;
-            outFile << console->getName() + "\t" + console->getTimestamp() + "\tCore: " + to_string(console->getCoreID()) + "\t" + to_string(console->getInstructionLine()) + "/" + to_string(console->getInstructionTotal()) + "\n";
-        }
-    }
-    outFile << "\n";
-    if (!hasQueued) outFile << "No queued consoles.\n"; */
-
-    outFile << "Running Processes:\n";
-    for (const auto& consolePair : consoles) {
-        AConsole* console = consolePair.second;
-        if (console->getStatus() == AConsole::RUNNING) {
-            hasRunning = true;
-            outFile << console->getName() + "\t" + console->getTimestamp() + "\tCore: " + to_string(console->getCoreID()) + "\t" + to_string(console->getInstructionLine()) + "/" + to_string(console->getInstructionTotal()) + "\n";
-        }
-    }
-    outFile << "\n";
-    if (!hasRunning) outFile << "No running consoles.\n";
-
-    outFile << "Finished Processes:\n";
-    for (const auto& consolePair : consoles) {
-        AConsole* console = consolePair.second;
-        if (console->getStatus() == AConsole::TERMINATED) {
-            hasFinished = true;
-            outFile << console->getName() + "\t" + console->getTimestamp() + "\tFinished\t" + to_string(console->getInstructionLine()) + "/" + to_string(console->getInstructionTotal()) + "\n";
-        }
-    }
-    outFile << "\n";
-    if (!hasFinished) outFile << "No terminated consoles.\n";
+    // Formatting and file I/O happen on the report writer's thread
+    vector<ReportRow> running = copyRows(AConsole::RUNNING);
+    vector<ReportRow> finished = copyRows(AConsole::TERMINATED);
 
-    outFile.close();
-    cout << "Report generated: " << fileName << "\n";
+    ReportWriter::writeAsync(fileName, outFile.str(), move(running), move(finished));
 }
 
 
 void ConsoleManager::startScheduler() {
+    // Latencies are filed under the scheduler that produced them
+    unique_ptr<SchedulingHistograms>& recorded = latencyHistograms[scheduler];
+    if (recorded == nullptr) {
+        recorded = make_unique<SchedulingHistograms>();
+    }
+    histograms = recorded.get();
+
+    // Policies are created before their scheduler thread starts, so reports
+    // can read a policy's statistics without processMutex
     if (scheduler == "fcfs") {
         thread schedulerThread(&ConsoleManager::schedulerFCFS, this);
 		schedulerThread.detach();
@@ -354,6 +772,21 @@ void ConsoleManager::startScheduler() {
         thread schedulerThread(&ConsoleManager::schedulerRR, this);
         schedulerThread.detach();
     }
+    else if (scheduler == "mlfq") {
+        createMlfqPolicy();
+        thread schedulerThread(&ConsoleManager::runPolicyScheduler, this);
+        schedulerThread.detach();
+    }
+    else if (scheduler == "fair") {
+        createFairPolicy();
+        thread schedulerThread(&ConsoleManager::runPolicyScheduler, this);
+        schedulerThread.detach();
+    }
+    else if (scheduler == "sjf" || scheduler == "srtf") {
+        createShortestFirstPolicy();
+        thread schedulerThread(&ConsoleManager::runPolicyScheduler, this);
+        schedulerThread.detach();
+    }
 }
 
 /*
@@ -363,15 +796,8 @@ void ConsoleManager::startScheduler() {
 * @return true if the console exists, false otherwise
 */
 bool ConsoleManager::consoleExists(const string& name) const {
-	// Check if the console name exists in the list of consoles
-    for (const auto& console : consoles) {
-        // If console exists
-        if (console.second->getName() == name) {
-            return true;
-        }
-    }
-    // If console does not exist
-    return false;
+	// Check if the console name exists in the process table
+    return consoles.find(name) != nullptr;
 }
 
 /*
@@ -389,183 +815,1258 @@ bool ConsoleManager::hasConsoles() const {
 * @param name - the name of the console
 */
 void ConsoleManager::loopConsole(const string& name) {
-    // Find specified console in the list of consoles
-    for (auto& console : consoles) {
-        // If console exists
-        if (console.second->getName() == name) {
-            vector<string> buffer;
-            string input;
-            currentConsole = true;
-
-            // Start console program
-            do {
-                buffer.clear();
-                cout << "Console [" << console.second->getName() << "] Enter a command: ";
-
-                // Read user input
-                while (cin >> input) {
-                    buffer.push_back(input);
-                    if (cin.peek() == '\n') break;
-                }
+    // Find specified console in the process table and pin it so it is not
+    // reaped while the screen is open
+    AConsole* console;
+    {
+        lock_guard<mutex> lock(reapMutex);
+        console = consoles.find(name);
+        if (console == nullptr) {
+            return;
+        }
+        attachedPid = console->getProcessID();
+    }
 
-                if (buffer.empty()) continue;
+    vector<string> buffer;
+    string input;
+    currentConsole = true;
 
-                const string& command = buffer[0];
+    // Start console program
+    do {
+        buffer.clear();
+        cout << "Console [" << console->getName() << "] Enter a command: ";
 
-                if (command == "exit") {
-                    return;  // Exit command
-                }
-                else if (command == "process-smi") {
-                    // Check if the process has finished
-                    if (console.second->getStatus() == AConsole::TERMINATED) {
-                        cout << "Finished!" << endl;
-                    }
+        // Read user input
+        while (cin >> input) {
+            buffer.push_back(input);
+            if (cin.peek() == '\n') break;
+        }
 
-                    else {
-                        // Display current process information
-                        cout << "Process: \"" << console.second->getName() << "\"" << endl;
-                        cout << "ID: " << console.second->getProcessID() << endl;  // Assuming you have a getID() function in AConsole
-                        // cout << "Created At: " << console.second->getTimestamp() << endl;
-                        cout << "Current Line of Instruction: " << console.second->getInstructionLine() << endl;
-                        cout << "Lines of Code: " << console.second->getInstructionTotal() << endl;
-                    }
-                }
-                else if (command == "running") {
-                    // Display running processes
-                    cout << "Running Processes:\n";
-                    bool hasRunning = false;
-                    for (const auto& consolePair : consoles) {
-                        AConsole* proc = consolePair.second;
-                        if (proc->getStatus() == AConsole::RUNNING) {
-                            hasRunning = true;
-                            cout << proc->getName() + "\t" +
-                                proc->getTimestamp() + "\t" +
-                                "Core: " + to_string(proc->getCoreID()) + "\t" +
-                                to_string(proc->getInstructionLine()) + "/" +
-                                to_string(proc->getInstructionTotal()) + "\n";
-                        }
-                    }
-                    if (!hasRunning) cout << "No running consoles.\n";
-                    cout << "\n";
-                }
-                else if (command == "finished") {
-                    // Display finished processes
-                    cout << "Finished Processes:\n";
-                    bool hasFinished = false;
-                    for (const auto& consolePair : consoles) {
-                        AConsole* proc = consolePair.second;
-                        if (proc->getStatus() == AConsole::TERMINATED) {
-                            hasFinished = true;
-                            cout << proc->getName() + "\t" +
-                                proc->getTimestamp() + "\t" +
-                                "Finished\t" +
-                                to_string(proc->getInstructionLine()) + "/" +
-                                to_string(proc->getInstructionTotal()) + "\n";
-                        }
-                    }
-                    if (!hasFinished) cout << "No finished consoles.\n";
-                }
-                else {
-                    cout << "Command [" << command << "] not recognized. Try again." << "\n";
-                }
+        if (buffer.empty()) continue;
 
-            } while (currentConsole);
-            return; // Exit console if not found
+        const string& command = buffer[0];
+
+        if (command == "exit") {
+            attachedPid = 0;
+            return;  // Exit command
         }
-    }
+        else if (command == "process-smi") {
+            AConsole::Snapshot state = console->snapshot();
+
+            // Check if the process has finished
+            if (state.status == AConsole::TERMINATED) {
+                cout << "Finished!" << endl;
+            }
+
+            else {
+                // Display current process information
+                cout << "Process: \"" << console->getName() << "\"" << endl;
+                cout << "ID: " << console->getProcessID() << endl;  // Assuming you have a getID() function in AConsole
+                // cout << "Created At: " << console->getTimestamp() << endl;
+                cout << "Current Line of Instruction: " << state.instructionLine << endl;
+                cout << "Lines of Code: " << state.instructionTotal << endl;
+            }
+        }
+        else if (command == "running") {
+            // Display running processes
+            cout << "Running Processes:\n";
+            vector<ReportRow> running = copyRows(AConsole::RUNNING);
+            for (const ReportRow& row : running) {
+                cout << row.name() + "\t" +
+                    row.timestamp() + "\t" +
+                    "Core: " + to_string(row.state.coreID) + "\t" +
+                    to_string(row.state.instructionLine) + "/" +
+                    to_string(row.state.instructionTotal) + "\n";
+            }
+            if (running.empty()) cout << "No running consoles.\n";
+            cout << "\n";
+        }
+        else if (command == "finished") {
+            // Display finished processes
+            cout << "Finished Processes:\n";
+            vector<ReportRow> finished = copyRows(AConsole::TERMINATED);
+            for (const ReportRow& row : finished) {
+                cout << row.name() + "\t" +
+                    row.timestamp() + "\t" +
+                    "Finished\t" +
+                    to_string(row.state.instructionLine) + "/" +
+                    to_string(row.state.instructionTotal) + "\n";
+            }
+            if (finished.empty()) cout << "No finished consoles.\n";
+        }
+        else {
+            cout << "Command [" << command << "] not recognized. Try again." << "\n";
+        }
+
+    } while (currentConsole);
 }
 
 AConsole::Status ConsoleManager::getConsoleStatus(const string& name) const {
-    // Check if the console name exists in the map
-    auto it = consoles.find(name);
-    if (it != consoles.end()) {
-        return it->second->getStatus(); // Return the status of the console
+    // A finished console can be reaped and returned to the pool at any time;
+    // reapMutex keeps it alive while its status is read
+    lock_guard<mutex> lock(reapMutex);
+
+    // Check if the console name exists in the process table
+    AConsole* console = consoles.find(name);
+    if (console != nullptr) {
+        return console->getStatus(); // Return the status of the console
     }
     // If console does not exist, return a default status (or handle it as you prefer)
     return AConsole::TERMINATED; // Assuming terminated is a safe fallback; you can change this
 }
 
+/*
+* This function records that a process has terminated and frees its memory.
+* When max-finished is set, the oldest finished processes beyond that limit are removed from the
+* process table and their records are returned to the console pool.
+*
+* @param process - the process that just terminated
+*/
+void ConsoleManager::retireProcess(AConsole* process) {
+    finishedCount.fetch_add(1, memory_order_relaxed);
+    if (histograms != nullptr && process->getArrivalNs() > 0 && process->getFinishedNs() > 0) {
+        histograms->turnaround.record(process->getFinishedNs() - process->getArrivalNs());
+    }
+    memory.release(process->getProcessID());
+    pagingManager.release(process->getProcessID());
+    if (max_finished == 0) return;
+
+    lock_guard<mutex> lock(reapMutex);
+    finishedPids.push_back(process->getProcessID());
+
+    while (finishedPids.size() > (size_t)max_finished) {
+        int pid = finishedPids.front();
+        finishedPids.pop_front();
+
+        // Never free a process whose screen is open
+        if (pid == attachedPid) {
+            finishedPids.push_back(pid);
+            continue;
+        }
+
+        AConsole* reaped = consoles.remove(pid);
+        if (reaped != nullptr) {
+            stateLists.remove(reaped);
+            consolePool.destroy(reaped);
+            reapedCount++;
+        }
+    }
+}
+
+/*
+* This function prints the console pool's allocation statistics
+*/
+void ConsoleManager::allocStats() {
+    ConsolePool::Stats stats = consolePool.getStats();
+
+    cout << "Live processes: " << stats.live << endl;
+    cout << "Peak live processes: " << stats.peak << endl;
+    cout << "Total allocated: " << stats.totalAllocated << endl;
+    cout << "Recycled allocations: " << stats.recycled << endl;
+    cout << "Reaped processes: " << reapedCount << endl;
+    cout << "Slabs: " << stats.slabs << " (" << stats.capacity << " records, "
+        << stats.capacity * sizeof(AConsole) / 1024 << " KB)" << endl;
+}
+
+/*
+* This function prints the demand paging statistics: frame usage, pages
+* moved to and from the backing store and the page fault rate
+*/
+void ConsoleManager::vmstat() {
+    if (!pagingManager.isEnabled()) {
+        cout << "Demand paging is off. Set max-overall-mem and mem-per-frame in config.txt to enable it.\n";
+        return;
+    }
+
+    PagingManager::Stats stats = pagingManager.getStats();
+    cout << "Page size: " << stats.pageSize << " bytes" << endl;
+    cout << "Frames used: " << stats.framesUsed << " / " << stats.frameCount << endl;
+    cout << "Memory accesses: " << stats.accesses << endl;
+    cout << "Page faults: " << stats.pageFaults << endl;
+    if (stats.accesses > 0) {
+        cout << "Fault rate: " << fixed << setprecision(4) << 100.0 * stats.pageFaults / stats.accesses << "% of accesses" << endl;
+    }
+    if (stats.elapsedSeconds > 0) {
+        cout << "Faults/sec: " << fixed << setprecision(2) << stats.pageFaults / stats.elapsedSeconds << endl;
+    }
+    cout << "Pages paged in: " << stats.pagedIn << endl;
+    cout << "Pages paged out: " << stats.pagedOut << endl;
+    cout << "Backing store: " << stats.backingSlotsUsed << " pages in use, " << stats.backingFileSize / 1024 << " KB file" << endl;
+}
+
+/*
+* This function samples the core counters twice, the given number of seconds
+* apart, and prints what each core did in between as rates per second
+*
+* @param seconds - the sampling interval
+*/
+void ConsoleManager::cpustat(int seconds) {
+    vector<CoreCounters::Sample> before(coreCount);
+    vector<CoreCounters::Sample> after(coreCount);
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < coreCount; ++i) {
+        before[i] = coreCounters[i].sample(counterNow());
+    }
+    this_thread::sleep_for(chrono::seconds(seconds));
+    for (int i = 0; i < coreCount; ++i) {
+        after[i] = coreCounters[i].sample(counterNow());
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << left << setw(6) << "core" << right << setw(8) << "util%" << setw(14) << "instr/s"
+         << setw(12) << "disp/s" << setw(12) << "preempt/s" << setw(12) << "cswitch/s" << endl;
+
+    CoreCounters::Sample total;
+    for (int i = 0; i <= coreCount; ++i) {
+        CoreCounters::Sample delta;
+        if (i < coreCount) {
+            delta.busyTime = after[i].busyTime - before[i].busyTime;
+            delta.idleTime = after[i].idleTime - before[i].idleTime;
+            delta.instructions = after[i].instructions - before[i].instructions;
+            delta.dispatches = after[i].dispatches - before[i].dispatches;
+            delta.preemptions = after[i].preemptions - before[i].preemptions;
+            delta.contextSwitches = after[i].contextSwitches - before[i].contextSwitches;
+
+            total.busyTime += delta.busyTime;
+            total.idleTime += delta.idleTime;
+            total.instructions += delta.instructions;
+            total.dispatches += delta.dispatches;
+            total.preemptions += delta.preemptions;
+            total.contextSwitches += delta.contextSwitches;
+        }
+        else {
+            delta = total;
+        }
+
+        uint64_t busyAndIdle = delta.busyTime + delta.idleTime;
+        double utilization = busyAndIdle > 0 ? min(100.0, 100.0 * delta.busyTime / busyAndIdle) : 0.0;
+        cout << left << setw(6) << (i < coreCount ? to_string(i) : "all") << right << fixed << setprecision(1)
+             << setw(8) << utilization << setw(14) << delta.instructions / elapsed
+             << setw(12) << delta.dispatches / elapsed << setw(12) << delta.preemptions / elapsed
+             << setw(12) << delta.contextSwitches / elapsed << endl;
+    }
+}
+
+/*
+* This function saves the configuration and every process, with its progress,
+* queue position and core, to a binary checkpoint file
+*
+* @param fileName - the checkpoint file
+*/
+void ConsoleManager::checkpoint(const string& fileName) {
+    CheckpointHeader config = {};
+    config.numCpu = num_cpu;
+    config.quantumCycles = quantum_cycles;
+    config.batchProcessFreq = batch_process_freq;
+    config.batchProcessCount = batch_process_count;
+    config.minIns = min_ins;
+    config.maxIns = max_ins;
+    config.delaysPerExec = delays_per_exec;
+    config.maxFinished = max_finished;
+    config.nextProcessId = nextProcessId;
+    config.mlfqLevels = mlfq_levels;
+    config.mlfqBoost = mlfq_boost;
+    config.fairLatency = fair_latency;
+    config.fairMinGranularity = fair_min_granularity;
+    // Quantums past the last level are never used
+    config.mlfqQuantumCount = (int32_t)min(mlfq_quantums.size(), (size_t)CHECKPOINT_MAX_MLFQ_LEVELS);
+    copy(mlfq_quantums.begin(), mlfq_quantums.begin() + config.mlfqQuantumCount, config.mlfqQuantums);
+    config.maxOverallMem = max_overall_mem;
+    config.memPerProc = mem_per_proc;
+    config.memPerFrame = mem_per_frame;
+    config.workloadSeed = workload_seed;
+    strncpy(config.scheduler, scheduler.c_str(), sizeof(config.scheduler) - 1);
+    strncpy(config.clockMode, clock_mode.c_str(), sizeof(config.clockMode) - 1);
+    strncpy(config.memAlloc, mem_alloc.c_str(), sizeof(config.memAlloc) - 1);
+    strncpy(config.coreAffinity, core_affinity.c_str(), sizeof(config.coreAffinity) - 1);
+    strncpy(config.processLog, process_log.c_str(), sizeof(config.processLog) - 1);
+    strncpy(config.workloadTrace, workload_trace.c_str(), sizeof(config.workloadTrace) - 1);
+
+    // Take one consistent view of the state lists. The waiting list is in
+    // enqueue order, which is the order the processes will be requeued in.
+    // Only pointers are copied under the list lock; reapMutex keeps the
+    // consoles alive while the records are built from them.
+    vector<CheckpointProcess> running;
+    vector<CheckpointProcess> waiting;
+    vector<CheckpointProcess> finished;
+    {
+        lock_guard<mutex> lock(reapMutex);
+        vector<pair<AConsole::Status, AConsole*>> listed;
+        listed.reserve(stateLists.count(AConsole::RUNNING) + stateLists.count(AConsole::WAITING) + stateLists.count(AConsole::TERMINATED));
+        stateLists.forEachState([&](AConsole::Status status, AConsole* console) {
+            listed.emplace_back(status, console);
+        });
+
+        for (const auto& [status, console] : listed) {
+            CheckpointProcess process = { console->getProcessID(), console->getName(), console->getTimestamp(), console->getDelaySeed(), console->snapshot() };
+            if (status == AConsole::RUNNING) running.push_back(move(process));
+            else if (status == AConsole::WAITING) waiting.push_back(move(process));
+            else finished.push_back(move(process));
+        }
+    }
+
+    stable_sort(running.begin(), running.end(), [](const CheckpointProcess& a, const CheckpointProcess& b) {
+        return a.state.coreID < b.state.coreID;
+    });
+
+    vector<CheckpointProcess> processes = move(running);
+    processes.insert(processes.end(), make_move_iterator(waiting.begin()), make_move_iterator(waiting.end()));
+    processes.insert(processes.end(), make_move_iterator(finished.begin()), make_move_iterator(finished.end()));
+
+    if (!CheckpointWriter::save(fileName, config, trace_file, processes)) {
+        cerr << "Error: unable to write checkpoint \"" << fileName << "\".\n";
+        return;
+    }
+    cout << "Checkpoint saved: " << fileName << " (" << processes.size() << " processes)\n";
+}
+
+/*
+* This function initializes the emulator from a checkpoint instead of
+* config.txt. Processes that were running are requeued first, in core order,
+* followed by the waiting queue in its saved order.
+*
+* @param fileName - the checkpoint file
+* @return true if the checkpoint was restored, false otherwise
+*/
+bool ConsoleManager::restore(const string& fileName) {
+    auto start = chrono::steady_clock::now();
+
+    CheckpointReader reader;
+    string error;
+    if (!reader.open(fileName, error)) {
+        cerr << "Error: could not restore checkpoint \"" << fileName << "\": " << error << ".\n";
+        return false;
+    }
+
+    const CheckpointHeader& header = reader.header();
+    auto text = [](const char* field, size_t size) {
+        return string(field, strnlen(field, size));
+    };
+
+    // The saved configuration goes through the same range checks as config.txt
+    ostringstream config;
+    config << "num-cpu " << header.numCpu << "\n"
+        << "scheduler " << quoted(text(header.scheduler, sizeof(header.scheduler))) << "\n"
+        << "quantum-cycles " << header.quantumCycles << "\n"
+        << "batch-process-freq " << header.batchProcessFreq << "\n"
+        << "batch-process-count " << header.batchProcessCount << "\n"
+        << "min-ins " << header.minIns << "\n"
+        << "max-ins " << header.maxIns << "\n"
+        << "delays-per-exec " << header.delaysPerExec << "\n"
+        << "max-finished " << header.maxFinished << "\n"
+        << "clock-mode " << quoted(text(header.clockMode, sizeof(header.clockMode))) << "\n"
+        << "core-affinity " << quoted(text(header.coreAffinity, sizeof(header.coreAffinity))) << "\n"
+        << "process-log " << quoted(text(header.processLog, sizeof(header.processLog))) << "\n"
+        << "max-overall-mem " << header.maxOverallMem << "\n"
+        << "mem-alloc " << quoted(text(header.memAlloc, sizeof(header.memAlloc))) << "\n"
+        << "mem-per-frame " << header.memPerFrame << "\n"
+        << "mlfq-levels " << header.mlfqLevels << "\n"
+        << "mlfq-quantum";
+    for (int32_t i = 0; i < header.mlfqQuantumCount; ++i) config << " " << header.mlfqQuantums[i];
+    config << "\n";
+    // These are 0 until config.txt sets them, which the range checks only
+    // accept as the unset default
+    if (header.memPerProc != 0) config << "mem-per-proc " << header.memPerProc << "\n";
+    else mem_per_proc = 0;
+    if (header.fairLatency != 0) config << "fair-latency " << header.fairLatency << "\n";
+    else fair_latency = 0;
+    config
+        << "mlfq-boost " << header.mlfqBoost << "\n"
+        << "fair-min-granularity " << header.fairMinGranularity << "\n"
+        << "seed " << header.workloadSeed << "\n"
+        << "workload-trace " << quoted(text(header.workloadTrace, sizeof(header.workloadTrace))) << "\n"
+        << "trace-file " << quoted(reader.traceFile()) << "\n";
+
+    istringstream savedConfig(config.str());
+    if (!applyConfig(savedConfig)) {
+        cerr << "Error: could not restore checkpoint \"" << fileName << "\": invalid configuration.\n";
+        return false;
+    }
+    nextProcessId = header.nextProcessId;
+
+    consoles.reserve(header.processCount);
+
+    for (uint64_t i = 0; i < header.processCount; ++i) {
+        const CheckpointRecord& record = reader.record(i);
+        AConsole::Status status = record.status == AConsole::TERMINATED ? AConsole::TERMINATED : AConsole::WAITING;
+
+        AConsole* console = consolePool.create(record.processID, reader.name(record), record.instructionTotal, reader.timestamp(record));
+        console->setDelaySeed(record.delaySeed);
+        console->restoreState(record.instructionLine, record.coreID, status);
+
+        if (consoles.findByPid(record.processID) != nullptr || !consoles.insert(console)) {
+            consolePool.destroy(console);
+            continue;
+        }
+        stateLists.move(console, status);
+
+        if (status == AConsole::TERMINATED) {
+            retireProcess(console);
+        }
+        else {
+            console->markEnqueued();
+            enqueueWaiting(console);
+        }
+    }
+
+    startCores();
+
+    double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << "Restored " << header.processCount << " processes from " << fileName << " in " << fixed << setprecision(2) << elapsed << " ms\n";
+    return true;
+}
+
 void ConsoleManager::schedulerTest(bool set_scheduler) {
     scheduler_test_run = set_scheduler;
+    if (!set_scheduler) return;
+
+    if (workload.getMode() == Workload::REPLAY) {
+        thread(&ConsoleManager::replayWorkload, this).detach();
+        return;
+    }
+
+    uint64_t stream = ++schedulerTestRuns;
+    thread([this, stream] {
+        // Each test run draws from its own fixed stream, so a run with the
+        // same seed creates the same processes
+        workload.seedThread(stream);
 
-    thread([this] {
         int cycles = 1;
-        int i = 1;
+        auto nextTick = chrono::steady_clock::now();
 
         while (scheduler_test_run) {
             if (cycles % batch_process_freq == 0) {
-                if (i < 10)
-                    addConsole("process00" + to_string(i));
-                else if (i < 100)
-                    addConsole("process0" + to_string(i));
-                else
-                    addConsole("process" + to_string(i));
-
-                i++;
+                addConsoles(batch_process_count);
             }
-            this_thread::sleep_for(chrono::milliseconds(100)); 
+            // Ticks keep a fixed schedule, so a large batch does not lower the rate
+            nextTick += chrono::milliseconds(100);
+            this_thread::sleep_until(nextTick);
             cycles++;
         }
     }).detach();
 }
 
-void ConsoleManager::schedulerFCFS() {
+/*
+* This function admits the arrivals of the replayed trace at their recorded
+* times from now, until the trace ends or scheduler-stop is given. Arrivals
+* that are due together are admitted as one batch.
+*/
+void ConsoleManager::replayWorkload() {
+    auto start = chrono::steady_clock::now();
+    size_t next = 0;
+    vector<Workload::Arrival> due;
+
+    while (next < workload.replayLength() && scheduler_test_run) {
+        this_thread::sleep_until(start + chrono::nanoseconds(workload.replayed(next).arrivalNs));
+        int64_t elapsedNs = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+        size_t room = admissionRoom();
+        due.clear();
+        while (next < workload.replayLength() && due.size() < room && workload.replayed(next).arrivalNs <= elapsedNs) {
+            due.push_back(workload.replayed(next++));
+        }
+        if (due.empty()) {
+            // The waiting queue is full; give the scheduler time to drain it
+            this_thread::sleep_for(chrono::milliseconds(1));
+            continue;
+        }
+        admitBatch(due.data(), due.size());
+    }
+}
+
+/*
+* This function spawns one long-lived worker thread per CPU core, so
+* dispatching a process never creates a thread. Under FCFS each worker sleeps
+* until the scheduler places a process in its core slot; under RR each worker
+* serves its own run queue and steals from other cores when it runs dry.
+*
+* @param quantum - the number of instructions a process may run before it is
+*                  preempted (0 means run to completion)
+*/
+void ConsoleManager::startCoreWorkers(int quantum) {
+    coreQuantum = quantum;
+    coreSlices = vector<int>(coreCount, quantum);
+    coreSlots = vector<AConsole*>(coreCount, nullptr);
+    coreWakeups = vector<condition_variable>(coreCount);
+    runQueues = vector<CoreRunQueue>(coreCount);
+    schedulerStart = chrono::steady_clock::now();
+    if (core_affinity == "on") {
+        affinity.configure();
+    }
+
+    for (int i = 0; i < coreCount; ++i) {
+        if (quantum > 0) {
+            coreWorkers.emplace_back(&ConsoleManager::coreWorkerRR, this, i);
+        }
+        else {
+            coreWorkers.emplace_back(&ConsoleManager::coreWorker, this, i);
+        }
+        coreWorkers.back().detach();
+    }
+}
+
+/*
+* This function is the body of an FCFS core worker thread. It waits for a
+* process to be assigned to its core, runs it, then frees the core.
+*
+* @param coreID - the ID of the CPU core this worker simulates
+*/
+void ConsoleManager::coreWorker(int coreID) {
+    if (affinity.isEnabled()) {
+        affinity.pinCurrentThread(coreID);
+    }
+    CoreCounters& counters = coreCounters[coreID];
+    counters.beginPeriod(counterNow(), false);
+    int lastProcessID = 0;
+
     while (true) {
-        this_thread::sleep_for(chrono::milliseconds(10));
+        AConsole* process;
+        int slice;
+        {
+            unique_lock<mutex> lock(processMutex);
+            coreWakeups[coreID].wait(lock, [this, coreID] { return coreSlots[coreID] != nullptr; });
+            process = coreSlots[coreID];
+            slice = coreSlices[coreID];
+        }
 
-        lock_guard<mutex> lock(processMutex);
+        counters.beginPeriod(counterNow(), true);
+        CoreCounters::add(counters.dispatches, 1);
+        if (process->getProcessID() != lastProcessID) {
+            CoreCounters::add(counters.contextSwitches, 1);
+            lastProcessID = process->getProcessID();
+        }
 
-        for (int i = 0; i < cpuCores.size(); ++i) {
-            if (!cpuCores[i] && !waitingQueue.empty()) {
-                AConsole* nextProcess = waitingQueue.front();
-                waitingQueue.pop();
+        recordDispatchLatency(process);
+        recordMigration(process, coreID);
+        int startLine = process->getInstructionLine();
+        process->runProcess(coreID, slice, delays_per_exec, &counters);
+        int executed = process->getInstructionLine() - startLine;
+        memory.recordQuantum();
+        counters.beginPeriod(counterNow(), false);
+
+        bool finished = process->getStatus() == AConsole::TERMINATED;
+        stateLists.move(process, process->getStatus());
+
+        {
+            lock_guard<mutex> lock(processMutex);
+            coreSlots[coreID] = nullptr;
+            cpuCores[coreID] = false;
+            availableCores++;
+
+            // Hand the process back to the policy; it must not be touched
+            // again once requeued or retired
+            if (policy != nullptr) {
+                if (finished) {
+                    policy->finished(process, executed, policyNow());
+                }
+                else if (process->getIsActive()) {
+                    process->markEnqueued();
+                    policy->requeue(process, executed, slice, policyNow());
+                }
+            }
+        }
 
-                cpuCores[i] = true;
-                availableCores--;
+        // Free the process's memory before waking the scheduler so the
+        // processes it deferred can be placed
+        if (finished) {
+            retireProcess(process);
+        }
+        notifyScheduler();
+    }
+}
 
-                runningProcesses[nextProcess->getName()] = thread([this, nextProcess, i]() {
-                    nextProcess->runProcess(i, 0, delays_per_exec);
-                    lock_guard<mutex> lock(processMutex);
-                    cpuCores[i] = false;
-					availableCores++;
-                    });
+/*
+* This function is the body of an RR core worker thread. The core runs the
+* process at the front of its own run queue for one quantum and puts it back
+* at the end of the same queue if it has not finished, so a process keeps
+* returning to the core it ran on. When the local queue is empty the core
+* steals from the busiest other core before going to sleep.
+*
+* @param coreID - the ID of the CPU core this worker simulates
+*/
+void ConsoleManager::coreWorkerRR(int coreID) {
+    CoreRunQueue& localQueue = runQueues[coreID];
+    if (affinity.isEnabled()) {
+        affinity.pinCurrentThread(coreID);
+    }
+    CoreCounters& counters = coreCounters[coreID];
+    counters.beginPeriod(counterNow(), false);
+    int lastProcessID = 0;
+
+    while (true) {
+        unsigned int seen = localQueue.eventCount();
+
+        AConsole* process;
+        if (!localQueue.pop(process) && !stealWork(coreID, process)) {
+            localQueue.waitForWork(seen);
+            continue;
+        }
+
+        setCoreBusy(coreID, true);
+        counters.beginPeriod(counterNow(), true);
+        CoreCounters::add(counters.dispatches, 1);
+        if (process->getProcessID() != lastProcessID) {
+            CoreCounters::add(counters.contextSwitches, 1);
+            lastProcessID = process->getProcessID();
+        }
 
-                runningProcesses[nextProcess->getName()].detach();
+        dispatchCount++;
+        recordDispatchLatency(process);
+        recordMigration(process, coreID);
+        stateLists.move(process, AConsole::RUNNING);
+        process->runProcess(coreID, coreQuantum, delays_per_exec, &counters);
+        memory.recordQuantum();
+        counters.beginPeriod(counterNow(), false);
+
+        // Decide before requeueing: once it is back on a queue another core
+        // may finish and reap it
+        bool finished = process->getStatus() == AConsole::TERMINATED;
+        stateLists.move(process, finished ? AConsole::TERMINATED : AConsole::WAITING);
+        if (!finished && process->getIsActive()) {
+            process->markEnqueued();
+            localQueue.push(process);
+        }
+        setCoreBusy(coreID, false);
+
+        if (finished) {
+            retireProcess(process);
+
+            // Processes waiting for memory may fit now
+            if (memory.isEnabled()) {
+                notifyScheduler();
             }
         }
 
-        
+        // Work is piling up here, let a sleeping core come and steal it
+        if (localQueue.size() > 1) {
+            wakeIdleCore(coreID);
+        }
     }
 }
 
-void ConsoleManager::schedulerRR() {
+/*
+* This function takes a process from the back of the most loaded other core's
+* run queue
+*
+* @param coreID - the ID of the idle core looking for work
+* @param process - receives the stolen process
+* @return true if a process was stolen, false if every other queue is empty
+*/
+bool ConsoleManager::stealWork(int coreID, AConsole*& process) {
+    int victim = -1;
+    size_t victimSize = 0;
+
+    for (int offset = 1; offset < coreCount; ++offset) {
+        int i = (coreID + offset) % coreCount;
+        size_t size = runQueues[i].size();
+        if (size > victimSize) {
+            victim = i;
+            victimSize = size;
+        }
+    }
+
+    return victim >= 0 && runQueues[victim].steal(process);
+}
+
+/*
+* This function wakes one idle core other than the given one so it can steal
+*
+* @param coreID - the ID of the core that has surplus work
+*/
+void ConsoleManager::wakeIdleCore(int coreID) {
+    for (int offset = 1; offset < coreCount; ++offset) {
+        int i = (coreID + offset) % coreCount;
+        if (runQueues[i].load() == 0) {
+            runQueues[i].notify();
+            return;
+        }
+    }
+}
+
+/*
+* This function marks an RR core as busy or idle in the shared CPU state. The
+* flag and the available-core count are atomic, so the core does not take
+* processMutex twice per quantum.
+*
+* @param coreID - the ID of the core
+* @param busy - true if the core has started running a process
+*/
+void ConsoleManager::setCoreBusy(int coreID, bool busy) {
+    runQueues[coreID].setRunning(busy);
+    cpuCores[coreID] = busy;
+    availableCores += busy ? -1 : 1;
+}
+
+/*
+* This function puts a process that is already scheduled back on the waiting
+* queue. If the ring is full the process goes on an overflow list instead, so
+* it is never dropped. The overflow list is the back of the queue: while it
+* holds anything, every process is added to it rather than to the ring, so
+* none overtakes the processes already there.
+*
+* @param process - the process
+*/
+void ConsoleManager::enqueueWaiting(AConsole* process) {
+    if (overflowCount.load(memory_order_acquire) == 0 && waitingQueue.tryPush(process)) return;
+
+    lock_guard<mutex> lock(overflowMutex);
+    overflowQueue.push_back(process);
+    overflowCount.fetch_add(1, memory_order_release);
+}
+
+/*
+* This function moves processes from the front of the overflow list into the
+* ring while it has room. The caller must hold overflowMutex.
+*/
+void ConsoleManager::refillWaiting() {
+    while (!overflowQueue.empty() && waitingQueue.tryPush(overflowQueue.front())) {
+        overflowQueue.pop_front();
+        overflowCount.fetch_sub(1, memory_order_release);
+    }
+}
+
+/*
+* This function takes the next waiting process. The ring holds the front of
+* the queue, so it is popped first, and the overflow list moves up into the
+* ring as the ring drains.
+*
+* @param process - receives the process
+* @return true if a process was taken, false if none is waiting
+*/
+bool ConsoleManager::popWaiting(AConsole*& process) {
+    if (waitingQueue.tryPop(process)) {
+        if (overflowCount.load(memory_order_acquire) > 0) {
+            lock_guard<mutex> lock(overflowMutex);
+            refillWaiting();
+        }
+        return true;
+    }
+    if (overflowCount.load(memory_order_acquire) == 0) return false;
+
+    // Nothing is added to the ring while the overflow list is in use, so an
+    // empty ring means the overflow front is the oldest waiting process
+    lock_guard<mutex> lock(overflowMutex);
+    if (waitingQueue.tryPop(process)) {
+        refillWaiting();
+        return true;
+    }
+    if (overflowQueue.empty()) return false;
+    process = overflowQueue.front();
+    overflowQueue.pop_front();
+    overflowCount.fetch_sub(1, memory_order_release);
+    refillWaiting();
+    return true;
+}
+
+/*
+* This function returns the number of waiting processes, counting the overflow
+* list and the processes waiting for memory. The result is only a snapshot
+* while other threads change the queue.
+*
+* @return the approximate number of waiting processes
+*/
+size_t ConsoleManager::waitingCount() const {
+    return waitingQueue.sizeApprox() + overflowCount.load(memory_order_acquire) + memoryWaitingCount.load(memory_order_relaxed);
+}
+
+/*
+* This function takes the next waiting process that is in memory or can be
+* given memory. Processes that do not fit line up on memoryWaiting in the
+* order they arrived, and the front of that line is the only one offered
+* memory, and only again after some memory was freed. Every block is
+* mem-per-proc bytes, so once it does not fit nothing else that needs memory
+* would; the rest of the queue is only checked for processes that already
+* hold memory, and each process is moved to the line at most once. Only the
+* scheduler thread calls this.
+*
+* @param process - receives the process
+* @return true if a process was taken, false otherwise
+*/
+bool ConsoleManager::popResidentProcess(AConsole*& process) {
+    if (!memory.isEnabled()) {
+        return popWaiting(process);
+    }
+
+    uint64_t releases = memory.releaseCount();
+    if (memoryWaiting.empty()) {
+        if (!popWaiting(process)) return false;
+        if (memory.allocate(process->getProcessID())) return true;
+        memoryWaiting.push_back(process);
+        memoryWaitingCount.fetch_add(1, memory_order_relaxed);
+    }
+    else if (releases != memoryReleasesSeen && memory.allocate(memoryWaiting.front()->getProcessID())) {
+        process = memoryWaiting.front();
+        memoryWaiting.pop_front();
+        memoryWaitingCount.fetch_sub(1, memory_order_relaxed);
+        return true;
+    }
+    memoryReleasesSeen = releases;
+
+    while (popWaiting(process)) {
+        if (memory.isResident(process->getProcessID())) return true;
+        memoryWaiting.push_back(process);
+        memoryWaitingCount.fetch_add(1, memory_order_relaxed);
+    }
+    return false;
+}
+
+/*
+* This function moves newly arrived processes from the waiting queue to the
+* run queue of the least loaded core, preferring idle cores. A process only
+* joins a run queue once it has memory.
+*/
+void ConsoleManager::distributeArrivals() {
+    AConsole* process;
+    while (popResidentProcess(process)) {
+        int target = 0;
+        for (int i = 1; i < coreCount; ++i) {
+            if (runQueues[i].load() < runQueues[target].load()) {
+                target = i;
+            }
+        }
+        runQueues[target].push(process);
+    }
+}
+
+/*
+* This function hands the processes at the front of the waiting queue to any
+* idle cores. The caller must hold processMutex.
+*/
+void ConsoleManager::dispatchToIdleCores() {
+    if (policy != nullptr) {
+        admitArrivals();
+    }
+
+    for (int i = 0; i < coreCount; ++i) {
+        if (!cpuCores[i]) {
+            AConsole* nextProcess;
+            if (policy != nullptr) {
+                nextProcess = policy->pickNext(policyNow());
+                if (nextProcess == nullptr) break;
+            }
+            else if (!popResidentProcess(nextProcess)) {
+                break;
+            }
+
+            int core = preferredCore(nextProcess, i);
+            if (policy != nullptr) {
+                coreSlices[core] = policy->timeslice(nextProcess);
+            }
+            cpuCores[core] = true;
+            availableCores--;
+            coreSlots[core] = nextProcess;
+            stateLists.move(nextProcess, AConsole::RUNNING);
+            dispatchCount++;
+            coreWakeups[core].notify_one();
+
+            // Core i is still idle if the process went back to its old core
+            if (core != i) --i;
+        }
+    }
+}
+
+/*
+* This function records how long a process waited between being enqueued and
+* starting to run on a core
+*
+* @param process - the process that is about to run
+*/
+void ConsoleManager::recordDispatchLatency(AConsole* process) {
+    int64_t now = AConsole::monotonicNs();
+    long long latency = now - chrono::duration_cast<chrono::nanoseconds>(process->getEnqueueTime().time_since_epoch()).count();
+    dispatchLatencyTotalNs += latency;
+
+    long long currentMax = dispatchLatencyMaxNs;
+    while (latency > currentMax && !dispatchLatencyMaxNs.compare_exchange_weak(currentMax, latency)) {}
+
+    if (histograms != nullptr) {
+        histograms->wait.record(latency);
+        if (process->getFirstDispatchNs() == 0) {
+            histograms->response.record(now - process->getArrivalNs());
+        }
+        else if (process->getLastPreemptNs() > process->getLastDispatchNs()) {
+            histograms->requeueWait.record(now - process->getLastPreemptNs());
+        }
+    }
+    process->markDispatched(now);
+}
+
+/*
+* This function prints the wait, requeue wait, response and turnaround
+* percentiles recorded under each scheduler that has run
+*
+* @param out - the stream to print to
+*/
+void ConsoleManager::printLatencyPercentiles(ostream& out) {
+    for (const auto& [name, recorded] : latencyHistograms) {
+        out << "Latency percentiles under " << name << " (ms):" << endl;
+        out << "  " << left << setw(14) << "" << right << setw(8) << "count" << setw(12) << "p50"
+            << setw(12) << "p90" << setw(12) << "p99" << setw(12) << "p99.9" << setw(12) << "max" << endl;
+        recorded->wait.print(out, "wait");
+        recorded->requeueWait.print(out, "requeue wait");
+        recorded->response.print(out, "response");
+        recorded->turnaround.print(out, "turnaround");
+    }
+}
+
+/*
+* This function returns the time the core counters are read at: nanoseconds
+* on the steady clock in real-time mode, 0 in virtual-clock mode where the
+* counters are already in ticks
+*
+* @return the current time
+*/
+int64_t ConsoleManager::counterNow() const {
+    if (clock_mode == "virtual") {
+        return 0;
+    }
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+* This function returns the totals a benchmark or other headless driver needs
+* without parsing the reports
+*
+* @return the processes finished, instructions executed, dispatches,
+*         migrations, cumulative utilization and latency histograms
+*/
+ConsoleManager::Metrics ConsoleManager::getMetrics() {
+    Metrics metrics = {};
+    metrics.finished = finishedCount.load(memory_order_relaxed);
+    metrics.dispatches = dispatchCount;
+    metrics.migrations = migrationCount;
+    metrics.latencies = histograms;
+
+    int64_t now = counterNow();
+    uint64_t busyTotal = 0, elapsedTotal = 0;
+    for (int i = 0; i < coreCount; ++i) {
+        CoreCounters::Sample sample = coreCounters[i].sample(now);
+        metrics.instructions += sample.instructions;
+        busyTotal += sample.busyTime;
+        elapsedTotal += sample.busyTime + sample.idleTime;
+    }
+    metrics.utilization = elapsedTotal > 0 ? busyTotal / (double)elapsedTotal : 0.0;
+    return metrics;
+}
+
+const Workload& ConsoleManager::getWorkload() const {
+    return workload;
+}
+
+/*
+* This function prints the share of time each core has been busy since the
+* scheduler started, and the average over all cores
+*
+* @param out - the stream to print to
+*/
+void ConsoleManager::printCoreUtilization(ostream& out) {
+    int64_t now = counterNow();
+    uint64_t busyTotal = 0, elapsedTotal = 0;
+    for (int i = 0; i < coreCount; ++i) {
+        CoreCounters::Sample sample = coreCounters[i].sample(now);
+        uint64_t elapsed = sample.busyTime + sample.idleTime;
+        busyTotal += sample.busyTime;
+        elapsedTotal += elapsed;
+        out << "Core " << i << " utilization: " << fixed << setprecision(2)
+            << (elapsed > 0 ? 100.0 * sample.busyTime / elapsed : 0.0) << "%, "
+            << sample.instructions << " instructions" << endl;
+    }
+    out << "Cumulative CPU utilization: " << fixed << setprecision(2)
+        << (elapsedTotal > 0 ? 100.0 * busyTotal / elapsedTotal : 0.0) << "%" << endl;
+}
+
+/*
+* This function counts a dispatch that moves a process to a different core
+* than the one it last ran on
+*
+* @param process - the process that is about to run
+* @param coreID - the core it is about to run on
+*/
+void ConsoleManager::recordMigration(const AConsole* process, int coreID) {
+    int lastCore = process->getCoreID();
+    if (lastCore >= 0 && lastCore != coreID) {
+        migrationCount++;
+    }
+}
+
+/*
+* This function picks the core for a dispatch: the core the process last ran
+* on if it is idle, so the process finds its state still in that core's
+* cache, otherwise the given idle core. The caller must hold processMutex.
+*
+* @param process - the process being dispatched
+* @param idleCore - an idle core to fall back on
+* @return the core to dispatch to
+*/
+int ConsoleManager::preferredCore(const AConsole* process, int idleCore) const {
+    int lastCore = process->getCoreID();
+    if (lastCore >= 0 && lastCore < coreCount && !cpuCores[lastCore]) {
+        return lastCore;
+    }
+    return idleCore;
+}
+
+/*
+* This function wakes the scheduler after a process is enqueued or a core is
+* freed. It bumps an event counter the scheduler futex-waits on, so producers
+* never have to take processMutex just to signal.
+*/
+void ConsoleManager::notifyScheduler() {
+    schedulerEvents.fetch_add(1, memory_order_release);
+    schedulerEvents.notify_one();
+}
+
+/*
+* This function is the scheduler loop shared by FCFS and RR. It sleeps until
+* a process is enqueued or a core is freed, and only then dispatches. Under RR
+* it only places arrivals on core run queues; the cores schedule themselves.
+*/
+void ConsoleManager::dispatchLoop() {
     while (true) {
-        this_thread::sleep_for(chrono::milliseconds(10));
+        // Read the event counter before looking at the queue so an enqueue that
+        // races with this pass makes the wait below return immediately
+        unsigned int seen = schedulerEvents.load(memory_order_acquire);
+        if (coreQuantum > 0) {
+            distributeArrivals();
+        }
+        else {
+            lock_guard<mutex> lock(processMutex);
+            dispatchToIdleCores();
+        }
+        schedulerEvents.wait(seen, memory_order_acquire);
+    }
+}
 
-        lock_guard<mutex> lock(processMutex);
+/*
+* This function drives every core from a simulated CPU tick instead of
+* wall-clock sleeps. On each tick idle cores are dispatched in core order,
+* then every busy core either burns one delay tick or executes one
+* instruction. delays-per-exec and SLEEP instructions are therefore counted in
+* ticks, and because all cores advance in lockstep the scheduling order is
+* deterministic. processMutex is released while the cores execute, so other
+* threads get the lock once per tick instead of racing for it at its edge.
+*
+* @param quantum - the number of instructions a process may run before it is
+*                  preempted (0 means run to completion)
+*/
+void ConsoleManager::virtualClockLoop(int quantum) {
+    struct VirtualCore {
+        AConsole* process = nullptr;
+        int executed = 0;
+        int stallTicks = 0;
+        int slice = 0;
+        bool hasMore = true;
+    };
+    vector<VirtualCore> cores(coreCount);
+    vector<int> lastProcessIDs(coreCount, 0);
+    schedulerStart = chrono::steady_clock::now();
+
+    unique_lock<mutex> lock(processMutex);
 
-        for (int i = 0; i < cpuCores.size(); ++i) {
-            if (!cpuCores[i] && !waitingQueue.empty()) {
-                AConsole* nextProcess = waitingQueue.front();
-                waitingQueue.pop();
+    while (true) {
+        if (availableCores == coreCount) {
+            unsigned int seen = schedulerEvents.load(memory_order_acquire);
+            if (waitingCount() == 0 && (policy == nullptr || policy->size() == 0)) {
+                lock.unlock();
+                schedulerEvents.wait(seen, memory_order_acquire);
+                lock.lock();
+                continue;
+            }
+        }
 
-                cpuCores[i] = true;
+        if (policy != nullptr) {
+            admitArrivals();
+        }
+
+        for (int i = 0; i < coreCount; ++i) {
+            if (!cpuCores[i]) {
+                AConsole* nextProcess;
+                int slice = quantum;
+                if (policy != nullptr) {
+                    nextProcess = policy->pickNext(virtualTicks);
+                    if (nextProcess == nullptr) break;
+                    slice = policy->timeslice(nextProcess);
+                }
+                else if (!popResidentProcess(nextProcess)) {
+                    break;
+                }
+
+                int core = preferredCore(nextProcess, i);
+                cpuCores[core] = true;
                 availableCores--;
+                cores[core] = { nextProcess, 0, delays_per_exec, slice };
+                dispatchCount++;
+                recordDispatchLatency(nextProcess);
+                recordMigration(nextProcess, core);
+                CoreCounters::add(coreCounters[core].dispatches, 1);
+                if (nextProcess->getProcessID() != lastProcessIDs[core]) {
+                    CoreCounters::add(coreCounters[core].contextSwitches, 1);
+                    lastProcessIDs[core] = nextProcess->getProcessID();
+                }
+                nextProcess->dispatch(core);
+                stateLists.move(nextProcess, AConsole::RUNNING);
+
+                // Core i is still idle if the process went back to its old core
+                if (core != i) --i;
+            }
+        }
 
-                runningProcesses[nextProcess->getName()] = thread([this, nextProcess, i]() {
-                    nextProcess->runProcess(i, quantum_cycles, delays_per_exec);
-                    lock_guard<mutex> lock(processMutex);
+        // Each dispatched process is owned by this thread until it is handed
+        // back below, so the cores execute without the lock
+        lock.unlock();
+        for (int i = 0; i < coreCount; ++i) {
+            VirtualCore& core = cores[i];
+            CoreCounters& counters = coreCounters[i];
+            if (core.process == nullptr) {
+                CoreCounters::add(counters.idleTime, 1);
+                continue;
+            }
+            CoreCounters::add(counters.busyTime, 1);
 
-                    // If the process has not completed, requeue it
-                    if (nextProcess->getIsActive() && nextProcess->getInstructionLine() < nextProcess->getInstructionTotal()) {
-                        waitingQueue.push(nextProcess);
-                    }
-                    cpuCores[i] = false;
-                    availableCores++;
-                    });
+            if (core.stallTicks > 0) {
+                core.stallTicks--;
+                continue;
+            }
 
-                runningProcesses[nextProcess->getName()].detach();
+            core.hasMore = core.process->executeInstruction();
+            core.executed++;
+            core.stallTicks = delays_per_exec + core.process->getSleepTicks();
+            CoreCounters::add(counters.instructions, 1);
+        }
+        lock.lock();
+
+        for (int i = 0; i < coreCount; ++i) {
+            VirtualCore& core = cores[i];
+            CoreCounters& counters = coreCounters[i];
+            if (core.process == nullptr) continue;
+
+            bool hasMore = core.hasMore;
+            if (hasMore && core.slice > 0 && core.executed >= core.slice) {
+                core.process->preempt();
+                CoreCounters::add(counters.preemptions, 1);
+                stateLists.move(core.process, AConsole::WAITING);
+                core.process->markEnqueued();
+                if (policy != nullptr) {
+                    policy->requeue(core.process, core.executed, core.slice, virtualTicks);
+                }
+                else {
+                    enqueueWaiting(core.process);
+                }
+                hasMore = false;
+            }
+
+            if (!hasMore) {
+                if (core.process->getStatus() == AConsole::TERMINATED) {
+                    stateLists.move(core.process, AConsole::TERMINATED);
+                    if (policy != nullptr) {
+                        policy->finished(core.process, core.executed, virtualTicks);
+                    }
+                    retireProcess(core.process);
+                }
+                core.process = nullptr;
+                cpuCores[i] = false;
+                availableCores++;
             }
         }
+
+        virtualTicks++;
+        if (quantum_cycles > 0 && virtualTicks % quantum_cycles == 0) {
+            memory.recordQuantum();
+        }
+    }
+}
+
+void ConsoleManager::schedulerFCFS() {
+    if (clock_mode == "virtual") {
+        virtualClockLoop(0);
+        return;
+    }
+    startCoreWorkers(0);
+    dispatchLoop();
+}
+
+/*
+* This function creates the multi-level feedback queue policy
+*/
+void ConsoleManager::createMlfqPolicy() {
+    vector<int> quantums = MlfqPolicy::levelQuantums(mlfq_quantums, mlfq_levels, quantum_cycles);
+    policy = make_unique<MlfqPolicy>(quantums, mlfq_boost, clock_mode == "virtual");
+}
+
+/*
+* This function creates the fair scheduler policy. The target latency defaults
+* to eight quantums, so eight processes per core get round robin sized slices.
+*/
+void ConsoleManager::createFairPolicy() {
+    int latency = fair_latency > 0 ? fair_latency : quantum_cycles * 8;
+    policy = make_unique<FairPolicy>(max(latency, 1), fair_min_granularity, num_cpu, clock_mode == "virtual");
+}
+
+/*
+* This function creates the shortest job first policy, or shortest remaining
+* time first when preempting every quantum-cycles instructions
+*/
+void ConsoleManager::createShortestFirstPolicy() {
+    policy = make_unique<RemainingTimePolicy>(scheduler == "srtf", quantum_cycles, clock_mode == "virtual");
+}
+
+/*
+* This function runs a scheduler whose ready queue is ordered by policy. Core
+* workers run whatever slice the policy hands out and give the process back
+* to the policy afterwards.
+*/
+void ConsoleManager::runPolicyScheduler() {
+    if (clock_mode == "virtual") {
+        virtualClockLoop(0);
+        return;
+    }
+    startCoreWorkers(0);
+    dispatchLoop();
+}
+
+/*
+* This function returns the current time in the policy's unit: ticks in
+* virtual-clock mode, nanoseconds since the scheduler started otherwise
+*
+* @return the current time
+*/
+int64_t ConsoleManager::policyNow() {
+    if (clock_mode == "virtual") {
+        return virtualTicks;
     }
-}
\ No newline at end of file
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - schedulerStart).count();
+}
+
+/*
+* This function hands every process in the waiting queue that has memory to
+* the scheduling policy. Must be called with processMutex held.
+*/
+void ConsoleManager::admitArrivals() {
+    AConsole* process;
+    int64_t now = policyNow();
+    while (popResidentProcess(process)) {
+        policy->admit(process, now);
+    }
+}
+
+/*
+* This function prints the statistics of the scheduling policy, if one is in
+* use. The policy publishes them in atomics, so processMutex is not taken.
+*
+* @param out - the stream to print to
+*/
+void ConsoleManager::printSchedulerStats(ostream& out) {
+    if (policy != nullptr) {
+        policy->printStats(out);
+    }
+}
+
+void ConsoleManager::schedulerRR() {
+    if (clock_mode == "virtual") {
+        virtualClockLoop(quantum_cycles);
+        return;
+    }
+    startCoreWorkers(quantum_cycles);
+    dispatchLoop();
+}
@@ -3,29 +3,134 @@
 #include <iostream>
 #include <thread>
 #include <queue>
+#include <deque>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <vector>
+#include <memory>
 #include "AConsole.h"
+#include "ReadyQueue.h"
+#include "CoreRunQueue.h"
+#include "ProcessTable.h"
+#include "ConsolePool.h"
+#include "ProcessStateLists.h"
+#include "MemoryManager.h"
+#include "SchedulerPolicy.h"
+#include "HostAffinity.h"
+#include "LatencyHistogram.h"
+#include "Workload.h"
+#include "ReportWriter.h"
 
 using namespace std;
 
 class ConsoleManager {
 private:
-    map<string, AConsole*> consoles;
+    ProcessTable consoles;
+    ConsolePool consolePool;
+    ProcessStateLists stateLists;
+    deque<int> finishedPids;
+    atomic<int> attachedPid{ 0 };
+    atomic<long long> reapedCount{ 0 };
+    mutable mutex reapMutex;
     bool reportingMode = false;
     bool currentConsole = false;
     int coreCount;
-    int availableCores;
-    vector<bool> cpuCores;
-    queue<AConsole*> waitingQueue;
-    map<string, thread> runningProcesses;
+    atomic<int> availableCores;
+    // Atomic so RR cores can flip their own flag without processMutex
+    vector<atomic<bool>> cpuCores;
+    ReadyQueue<AConsole*> waitingQueue{ 1 << 20 };
+    deque<AConsole*> overflowQueue;
+    mutex overflowMutex;
+    atomic<size_t> overflowCount{ 0 };
+    // Waiting processes that did not fit in memory, in arrival order. Only
+    // the scheduler thread touches the list.
+    deque<AConsole*> memoryWaiting;
+    atomic<size_t> memoryWaitingCount{ 0 };
+    uint64_t memoryReleasesSeen = 0;
+    vector<thread> coreWorkers;
+    vector<AConsole*> coreSlots;
+    vector<condition_variable> coreWakeups;
+    vector<CoreRunQueue> runQueues;
+    vector<int> coreSlices;
+    int coreQuantum = 0;
+    unique_ptr<SchedulerPolicy> policy;
     mutex processMutex;
+    atomic<unsigned int> schedulerEvents{ 0 };
+    MemoryManager memory;
+    HostAffinity affinity;
+    Workload workload;
+    uint64_t schedulerTestRuns = 0;
+    unique_ptr<CoreCounters[]> coreCounters;
+    map<string, unique_ptr<SchedulingHistograms>> latencyHistograms;
+    SchedulingHistograms* histograms = nullptr;
+    atomic<int> nextProcessId{ 1 };
+    atomic<long long> dispatchCount{ 0 };
+    atomic<long long> migrationCount{ 0 };
+    atomic<uint64_t> finishedCount{ 0 };
+    atomic<long long> dispatchLatencyTotalNs{ 0 };
+    atomic<long long> dispatchLatencyMaxNs{ 0 };
+    atomic<long long> virtualTicks{ 0 };
+    chrono::steady_clock::time_point schedulerStart;
+
+    void startCores();
+    void startCoreWorkers(int quantum);
+    void coreWorker(int coreID);
+    void coreWorkerRR(int coreID);
+    bool stealWork(int coreID, AConsole*& process);
+    void wakeIdleCore(int coreID);
+    void distributeArrivals();
+    void setCoreBusy(int coreID, bool busy);
+    void dispatchToIdleCores();
+    void dispatchLoop();
+    void notifyScheduler();
+    void virtualClockLoop(int quantum);
+    void runPolicyScheduler();
+    void createMlfqPolicy();
+    void createFairPolicy();
+    void createShortestFirstPolicy();
+    int64_t policyNow();
+    void admitArrivals();
+    void printSchedulerStats(ostream& out);
+    void recordDispatchLatency(AConsole* process);
+    void printLatencyPercentiles(ostream& out);
+    void recordMigration(const AConsole* process, int coreID);
+    int preferredCore(const AConsole* process, int idleCore) const;
+    void printDispatchStats(ostream& out);
+    void printProcessCounts(ostream& out);
+    void printCoreUtilization(ostream& out);
+    int64_t counterNow() const;
+    void printMemoryStats(ostream& out);
+    vector<ReportRow> copyRows(AConsole::Status status) const;
+    void enqueueWaiting(AConsole* process);
+    void refillWaiting();
+    bool popWaiting(AConsole*& process);
+    size_t waitingCount() const;
+    bool popResidentProcess(AConsole*& process);
+    void retireProcess(AConsole* process);
+    void admitConsole(const string& name, const Workload::Arrival& arrival, bool fromScreenCommand);
+    size_t admitBatch(const Workload::Arrival* arrivals, size_t count);
+    size_t admissionRoom() const;
+    void replayWorkload();
 
 public:
-    void initialize();
+    // Totals since the scheduler started, for headless drivers
+    struct Metrics {
+        uint64_t finished;
+        uint64_t instructions;
+        long long dispatches;
+        long long migrations;
+        double utilization;
+        const SchedulingHistograms* latencies;
+    };
+
+    void initialize(const string& configFile = "config.txt");
     void addConsole(const string& name, bool fromScreenCommand);
+    size_t addConsoles(size_t count);
     void readConfig(const string& filename);
+    bool applyConfig(istream& config);
     void testConfig();
     void displayConsole(const string& name) const;
     void displayCPUInfo();
@@ -37,6 +142,13 @@ public:
     AConsole::Status getConsoleStatus(const string& name) const;
     void loopConsole(const string& name);
     void schedulerTest(bool set_scheduler);
+    void allocStats();
+    void vmstat();
+    void cpustat(int seconds);
+    void checkpoint(const string& fileName);
+    bool restore(const string& fileName);
+    Metrics getMetrics();
+    const Workload& getWorkload() const;
     void schedulerFCFS();
     void schedulerRR();
 };
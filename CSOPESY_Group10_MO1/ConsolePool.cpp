@@ -0,0 +1,117 @@
+#include "ConsolePool.h"
+
+/*
+* This function constructs a new console in a pooled slot, reusing a freed
+* slot when one is available
+*
+* @param processID - the process ID of the console
+* @param name - the name of the console
+* @param instructionTotal - the total number of instructions
+* @return the new console
+*/
+AConsole* ConsolePool::create(int processID, const string& name, int instructionTotal) {
+    return new (allocateSlot()->storage) AConsole(processID, name, instructionTotal);
+}
+
+/*
+* This function constructs a console with a known creation timestamp in a
+* pooled slot
+*
+* @param processID - the process ID of the console
+* @param name - the name of the console
+* @param instructionTotal - the total number of instructions
+* @param timestamp - the time the console was originally created
+* @return the new console
+*/
+AConsole* ConsolePool::create(int processID, const string& name, int instructionTotal, const string& timestamp) {
+    return new (allocateSlot()->storage) AConsole(processID, name, instructionTotal, timestamp);
+}
+
+/*
+* This function constructs a batch of consoles with consecutive process IDs
+* and names derived from them, taking the pool lock once for the whole batch
+*
+* @param firstProcessID - the process ID of the first console
+* @param instructionTotals - the total number of instructions of each console
+* @param count - the number of consoles
+* @param createdAt - the time the consoles were created
+* @param consoles - receives the new consoles
+*/
+void ConsolePool::createBatch(int firstProcessID, const int* instructionTotals, size_t count, time_t createdAt, AConsole** consoles) {
+    {
+        lock_guard<mutex> lock(poolMutex);
+        for (size_t i = 0; i < count; ++i) {
+            consoles[i] = reinterpret_cast<AConsole*>(takeSlot());
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        new (consoles[i]) AConsole(firstProcessID + (int)i, instructionTotals[i], createdAt);
+    }
+}
+
+/*
+* This function takes a slot off the free list, or carves a new one out of
+* the current slab
+*
+* @return an unconstructed slot
+*/
+ConsolePool::Slot* ConsolePool::allocateSlot() {
+    lock_guard<mutex> lock(poolMutex);
+    return takeSlot();
+}
+
+/*
+* This function takes a slot off the free list or the current slab. The
+* caller must hold poolMutex.
+*
+* @return an unconstructed slot
+*/
+ConsolePool::Slot* ConsolePool::takeSlot() {
+    Slot* slot;
+    if (freeList != nullptr) {
+        slot = freeList;
+        freeList = freeList->next;
+        stats.recycled++;
+    }
+    else {
+        if (nextInSlab == SLAB_SIZE) {
+            slabs.push_back(make_unique<Slot[]>(SLAB_SIZE));
+            nextInSlab = 0;
+            stats.slabs++;
+            stats.capacity += SLAB_SIZE;
+        }
+        slot = &slabs.back()[nextInSlab++];
+    }
+
+    stats.live++;
+    stats.totalAllocated++;
+    if (stats.live > stats.peak) stats.peak = stats.live;
+
+    return slot;
+}
+
+/*
+* This function destroys a console and returns its slot to the free list
+*
+* @param console - a console previously returned by create
+*/
+void ConsolePool::destroy(AConsole* console) {
+    console->~AConsole();
+    Slot* slot = reinterpret_cast<Slot*>(console);
+
+    lock_guard<mutex> lock(poolMutex);
+    slot->next = freeList;
+    freeList = slot;
+    stats.live--;
+}
+
+/*
+* This function returns a copy of the pool's allocation statistics
+*
+* @return stats - the live, peak, recycled and total allocation counts
+*/
+ConsolePool::Stats ConsolePool::getStats() const {
+    lock_guard<mutex> lock(poolMutex);
+    return stats;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+#include "AConsole.h"
+
+using namespace std;
+
+/*
+* A slab allocator for AConsole records.
+*
+* Records are carved out of fixed-size slabs and freed records go onto an
+* intrusive free list, so admitting a process after one has been reaped
+* reuses its memory instead of calling malloc. Slabs are never returned to
+* the system; the pool's footprint is set by the peak number of live
+* processes.
+*/
+class ConsolePool {
+public:
+    struct Stats {
+        size_t live;
+        size_t peak;
+        size_t recycled;
+        size_t totalAllocated;
+        size_t slabs;
+        size_t capacity;
+    };
+
+private:
+    static constexpr size_t SLAB_SIZE = 1024;
+
+    union Slot {
+        Slot* next;
+        alignas(AConsole) unsigned char storage[sizeof(AConsole)];
+    };
+
+    vector<unique_ptr<Slot[]>> slabs;
+    Slot* freeList = nullptr;
+    size_t nextInSlab = SLAB_SIZE;
+    Stats stats{};
+    mutable mutex poolMutex;
+
+    Slot* allocateSlot();
+    Slot* takeSlot();
+
+public:
+    ConsolePool() = default;
+    ConsolePool(const ConsolePool&) = delete;
+    ConsolePool& operator=(const ConsolePool&) = delete;
+
+    AConsole* create(int processID, const string& name, int instructionTotal);
+    AConsole* create(int processID, const string& name, int instructionTotal, const string& timestamp);
+    void createBatch(int firstProcessID, const int* instructionTotals, size_t count, time_t createdAt, AConsole** consoles);
+    void destroy(AConsole* console);
+    Stats getStats() const;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+using namespace std;
+
+/*
+* Activity counters of one simulated core.
+*
+* Each core's counters fill their own cache line and only the thread that
+* runs the core writes them, so an update is a plain load and store with no
+* locked instruction and no cache line bouncing between cores. Readers take
+* relaxed snapshots, which may be a few events behind but never torn.
+*
+* Busy and idle time are nanoseconds in real-time mode and ticks in
+* virtual-clock mode. In real-time mode a core also publishes when its current
+* busy or idle period began, so a sample taken in the middle of a long slice
+* still counts the time spent in it.
+*/
+struct alignas(64) CoreCounters {
+    struct Sample {
+        uint64_t busyTime = 0;
+        uint64_t idleTime = 0;
+        uint64_t instructions = 0;
+        uint64_t dispatches = 0;
+        uint64_t preemptions = 0;
+        uint64_t contextSwitches = 0;
+    };
+
+    atomic<uint64_t> busyTime{ 0 };
+    atomic<uint64_t> idleTime{ 0 };
+    atomic<uint64_t> instructions{ 0 };
+    atomic<uint64_t> dispatches{ 0 };
+    atomic<uint64_t> preemptions{ 0 };
+    atomic<uint64_t> contextSwitches{ 0 };
+    atomic<int64_t> periodStart{ 0 };
+    atomic<bool> busy{ false };
+
+    /*
+    * This function adds to a counter. Only the thread running the core may
+    * call it.
+    *
+    * @param counter - one of this core's counters
+    * @param amount - the amount to add
+    */
+    static void add(atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+    }
+
+    /*
+    * This function ends the current real-time period and starts a busy or
+    * idle one. Only the thread running the core may call it.
+    *
+    * @param nowNs - the current time in nanoseconds
+    * @param isBusy - true if the core starts running a process
+    */
+    void beginPeriod(int64_t nowNs, bool isBusy) {
+        int64_t start = periodStart.load(memory_order_relaxed);
+        if (start > 0 && nowNs > start) {
+            add(busy.load(memory_order_relaxed) ? busyTime : idleTime, (uint64_t)(nowNs - start));
+        }
+        busy.store(isBusy, memory_order_relaxed);
+        periodStart.store(nowNs, memory_order_relaxed);
+    }
+
+    /*
+    * This function reads the counters, counting the open real-time period up
+    * to now
+    *
+    * @param nowNs - the current time in nanoseconds, 0 in virtual-clock mode
+    * @return the counter values
+    */
+    Sample sample(int64_t nowNs = 0) const {
+        Sample values = {
+            busyTime.load(memory_order_relaxed),
+            idleTime.load(memory_order_relaxed),
+            instructions.load(memory_order_relaxed),
+            dispatches.load(memory_order_relaxed),
+            preemptions.load(memory_order_relaxed),
+            contextSwitches.load(memory_order_relaxed)
+        };
+
+        int64_t start = periodStart.load(memory_order_relaxed);
+        if (nowNs > 0 && start > 0 && nowNs > start) {
+            (busy.load(memory_order_relaxed) ? values.busyTime : values.idleTime) += (uint64_t)(nowNs - start);
+        }
+        return values;
+    }
+};
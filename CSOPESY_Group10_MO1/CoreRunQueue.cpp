@@ -0,0 +1,107 @@
+#include "CoreRunQueue.h"
+
+/*
+* This function appends a process to the back of the queue and wakes the
+* owning core if it is idle
+*
+* @param process - the process to enqueue
+*/
+void CoreRunQueue::push(AConsole* process) {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        processes.push_back(process);
+        queued++;
+    }
+    notify();
+}
+
+/*
+* This function removes the process at the front of the queue. Only the
+* owning core calls it.
+*
+* @param process - receives the dequeued process
+* @return true if a process was dequeued, false if the queue is empty
+*/
+bool CoreRunQueue::pop(AConsole*& process) {
+    if (queued == 0) return false;
+
+    lock_guard<mutex> lock(queueMutex);
+    if (processes.empty()) return false;
+    process = processes.front();
+    processes.pop_front();
+    queued--;
+    return true;
+}
+
+/*
+* This function removes the process at the back of the queue on behalf of
+* another, idle core
+*
+* @param process - receives the stolen process
+* @return true if a process was stolen, false if the queue is empty
+*/
+bool CoreRunQueue::steal(AConsole*& process) {
+    if (queued == 0) return false;
+
+    lock_guard<mutex> lock(queueMutex);
+    if (processes.empty()) return false;
+    process = processes.back();
+    processes.pop_back();
+    queued--;
+    return true;
+}
+
+/*
+* This function returns the number of processes waiting in the queue
+*
+* @return queued - the number of queued processes
+*/
+size_t CoreRunQueue::size() const {
+    return queued;
+}
+
+/*
+* This function returns the number of processes assigned to the core,
+* counting the one currently running on it
+*
+* @return the queued processes plus one if the core is busy
+*/
+size_t CoreRunQueue::load() const {
+    return queued + (running ? 1 : 0);
+}
+
+/*
+* This function records whether the owning core is currently running a process
+*
+* @param isRunning - true if the core is busy
+*/
+void CoreRunQueue::setRunning(bool isRunning) {
+    running = isRunning;
+}
+
+/*
+* This function returns the wakeup counter. Read it before checking for work
+* and pass it to waitForWork so a push in between is never missed.
+*
+* @return events - the current wakeup counter
+*/
+unsigned int CoreRunQueue::eventCount() const {
+    return events.load(memory_order_acquire);
+}
+
+/*
+* This function blocks the owning core until the wakeup counter moves past seen
+*
+* @param seen - the value returned by eventCount before the core found no work
+*/
+void CoreRunQueue::waitForWork(unsigned int seen) {
+    events.wait(seen, memory_order_acquire);
+}
+
+/*
+* This function wakes the owning core
+*/
+void CoreRunQueue::notify() {
+    events.fetch_add(1, memory_order_release);
+    events.notify_one();
+}
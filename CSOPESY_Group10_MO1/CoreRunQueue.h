@@ -0,0 +1,36 @@
+#pragma once
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include "AConsole.h"
+
+using namespace std;
+
+/*
+* The local run queue of one simulated core under Round Robin.
+*
+* The owning core pops from the front and requeues preempted processes at the
+* back; idle cores steal from the back. Each queue has its own small lock, so
+* cores only contend when one of them is stealing. The queue also carries the
+* core's wakeup counter, which an idle core futex-waits on until work is
+* pushed to it.
+*/
+class alignas(64) CoreRunQueue {
+private:
+    mutex queueMutex;
+    deque<AConsole*> processes;
+    atomic<size_t> queued{ 0 };
+    atomic<bool> running{ false };
+    atomic<unsigned int> events{ 0 };
+
+public:
+    void push(AConsole* process);
+    bool pop(AConsole*& process);
+    bool steal(AConsole*& process);
+    size_t size() const;
+    size_t load() const;
+    void setRunning(bool isRunning);
+    unsigned int eventCount() const;
+    void waitForWork(unsigned int seen);
+    void notify();
+};
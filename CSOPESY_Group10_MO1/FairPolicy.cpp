@@ -0,0 +1,147 @@
+#include <algorithm>
+#include "FairPolicy.h"
+
+/*
+* This constructor creates an empty fair scheduler
+*
+* @param targetLatency - the instructions in which every runnable process should run once per core
+* @param minGranularity - the smallest slice a process is given
+* @param coreCount - the number of cores sharing the runnable processes
+* @param virtualClock - true if times are virtual ticks
+*/
+FairPolicy::FairPolicy(int targetLatency, int minGranularity, int coreCount, bool virtualClock)
+    : SchedulerPolicy(virtualClock), targetLatency(targetLatency), minGranularity(minGranularity), coreCount(coreCount) {}
+
+/*
+* This function inserts a process into the tree and tracks the spread of
+* virtual runtimes
+*
+* @param process - the process
+* @param now - the current time
+*/
+void FairPolicy::push(AConsole* process, int64_t now) {
+    process->getSchedulingInfo().readyTime = now;
+    runnable.insert(process);
+    publishTree();
+    raise(maxSpread, spread.load(memory_order_relaxed));
+}
+
+/*
+* This function publishes the size of the tree and the spread of virtual
+* runtimes in it, for printStats
+*/
+void FairPolicy::publishTree() {
+    runnableCount.store(runnable.size(), memory_order_relaxed);
+    uint64_t current = runnable.empty() ? 0 : (*runnable.rbegin())->getSchedulingInfo().vruntime - (*runnable.begin())->getSchedulingInfo().vruntime;
+    spread.store(current, memory_order_relaxed);
+}
+
+/*
+* This function admits a new process one slice behind the smallest virtual
+* runtime, so a stream of arrivals cannot keep overtaking waiting processes
+*
+* @param process - the process
+* @param now - the current time
+*/
+void FairPolicy::admit(AConsole* process, int64_t now) {
+    AConsole::SchedulingInfo& info = process->getSchedulingInfo();
+    info.arrivalTime = now;
+    info.vruntime = minVruntime.load(memory_order_relaxed) + timeslice(process);
+    push(process, now);
+}
+
+/*
+* This function charges a process for the instructions it ran and puts it
+* back in the tree
+*
+* @param process - the process
+* @param executed - the instructions it ran
+* @param slice - the slice it was given
+* @param now - the current time
+*/
+void FairPolicy::requeue(AConsole* process, int executed, [[maybe_unused]] int slice, int64_t now) {
+    process->getSchedulingInfo().vruntime += executed;
+    push(process, now);
+}
+
+/*
+* This function takes the process with the smallest virtual runtime
+*
+* @param now - the current time
+* @return the process, or nullptr if no process is runnable
+*/
+AConsole* FairPolicy::pickNext(int64_t now) {
+    if (runnable.empty()) return nullptr;
+
+    AConsole* process = *runnable.begin();
+    runnable.erase(runnable.begin());
+    publishTree();
+
+    AConsole::SchedulingInfo& info = process->getSchedulingInfo();
+    raise(minVruntime, info.vruntime);
+
+    int64_t wait = now - info.readyTime;
+    add(waitTotal, wait);
+    raise(maxWait, wait);
+    add(dispatches, 1);
+    return process;
+}
+
+/*
+* This function splits the target latency among the runnable processes
+* of each core
+*
+* @param process - the process
+* @return the number of instructions it may run
+*/
+int FairPolicy::timeslice([[maybe_unused]] AConsole* process) {
+    // The dispatched process is no longer in the tree but still competes
+    size_t perCore = (runnable.size() + 1 + coreCount - 1) / coreCount;
+    int slice = (int)(targetLatency / perCore);
+    return max(slice, minGranularity);
+}
+
+/*
+* This function records the rate at which a finished process was served, for
+* Jain's fairness index
+*
+* @param process - the process
+* @param executed - the instructions it ran in its last slice
+* @param now - the current time
+*/
+void FairPolicy::finished(AConsole* process, [[maybe_unused]] int executed, int64_t now) {
+    int64_t turnaround = max<int64_t>(now - process->getSchedulingInfo().arrivalTime, 1);
+    double rate = process->getInstructionTotal() / (double)turnaround;
+    add(rateSum, rate);
+    add(rateSquareSum, rate * rate);
+    add(finishedCount, 1);
+}
+
+size_t FairPolicy::size() const {
+    return runnable.size();
+}
+
+/*
+* This function prints the wait times, the virtual runtime spread and Jain's
+* fairness index over the service rates of finished processes, where 1 means
+* every process was served at the same rate
+*
+* @param out - the stream to print to
+*/
+void FairPolicy::printStats(ostream& out) const {
+    uint64_t dispatched = dispatches.load(memory_order_relaxed);
+    uint64_t finished = finishedCount.load(memory_order_relaxed);
+
+    out << "Fair scheduler: target latency " << targetLatency << ", min granularity " << minGranularity
+        << ", " << runnableCount.load(memory_order_relaxed) << " runnable, min vruntime " << minVruntime.load(memory_order_relaxed) << endl;
+    out << "Vruntime spread: " << spread.load(memory_order_relaxed) << " (max " << maxSpread.load(memory_order_relaxed) << ")" << endl;
+    if (dispatched > 0) {
+        out << "Fair dispatches: " << dispatched << ", avg wait " << formatTime(waitTotal.load(memory_order_relaxed) / (double)dispatched)
+            << ", max wait " << formatTime((double)maxWait.load(memory_order_relaxed)) << endl;
+    }
+    if (finished > 0) {
+        double sum = rateSum.load(memory_order_relaxed);
+        double jain = sum * sum / (finished * rateSquareSum.load(memory_order_relaxed));
+        out << "Jain's fairness index: " << fixed << setprecision(3) << jain << " over " << finished << " finished" << endl;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <set>
+#include "SchedulerPolicy.h"
+
+using namespace std;
+
+/*
+* Completely fair scheduling.
+*
+* Every process accumulates virtual runtime, the number of instructions it
+* has executed. Runnable processes sit in a red-black tree ordered by virtual
+* runtime and the leftmost one, the process that has run the least, is always
+* dispatched next. Picking and requeueing are both O(log n).
+*
+* Instead of a fixed quantum, the target latency is shared among the runnable
+* processes so each of them runs once per latency period, but never for less
+* than the minimum granularity. A new process starts one slice past the
+* smallest virtual runtime in the tree, so it can neither starve the others by
+* catching up nor be starved by later arrivals.
+*/
+class FairPolicy : public SchedulerPolicy {
+private:
+    struct ByVruntime {
+        bool operator()(AConsole* a, AConsole* b) const {
+            uint64_t left = a->getSchedulingInfo().vruntime;
+            uint64_t right = b->getSchedulingInfo().vruntime;
+            if (left != right) return left < right;
+            return a->getProcessID() < b->getProcessID();
+        }
+    };
+
+    set<AConsole*, ByVruntime> runnable;
+    int targetLatency;
+    int minGranularity;
+    int coreCount;
+    atomic<uint64_t> minVruntime{ 0 };
+
+    atomic<size_t> runnableCount{ 0 };
+    atomic<uint64_t> spread{ 0 };
+    atomic<uint64_t> dispatches{ 0 };
+    atomic<int64_t> waitTotal{ 0 };
+    atomic<int64_t> maxWait{ 0 };
+    atomic<uint64_t> maxSpread{ 0 };
+    atomic<uint64_t> finishedCount{ 0 };
+    atomic<double> rateSum{ 0 };
+    atomic<double> rateSquareSum{ 0 };
+
+    void push(AConsole* process, int64_t now);
+    void publishTree();
+
+public:
+    FairPolicy(int targetLatency, int minGranularity, int coreCount, bool virtualClock);
+
+    void admit(AConsole* process, int64_t now) override;
+    void requeue(AConsole* process, int executed, int slice, int64_t now) override;
+    AConsole* pickNext(int64_t now) override;
+    int timeslice(AConsole* process) override;
+    void finished(AConsole* process, int executed, int64_t now) override;
+    size_t size() const override;
+    void printStats(ostream& out) const override;
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+using namespace std;
+
+/*
+* splitmix64, the generator behind process bodies, instruction delays and
+* workload arrivals. Its whole state is one word and each value costs a few
+* multiplies, so every thread can keep its own seeded copy instead of
+* building a random_device and an engine per process.
+*/
+class FastRandom {
+private:
+    uint64_t state;
+
+public:
+    static constexpr uint64_t GAMMA = 0x9E3779B97F4A7C15ull;
+
+    explicit FastRandom(uint64_t seed = 0) : state(seed) {}
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t next() {
+        return mix(state += GAMMA);
+    }
+
+    // A value in [low, high], scaled with a multiply instead of a division
+    int between(int low, int high) {
+        uint64_t range = (uint64_t)(uint32_t)(high - low) + 1;
+        return low + (int)(((next() >> 32) * range) >> 32);
+    }
+};
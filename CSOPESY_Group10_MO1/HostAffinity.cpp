@@ -0,0 +1,104 @@
+#include <iostream>
+#include "HostAffinity.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/*
+* This function reads the host CPUs the emulator is allowed to run on
+*
+* @return true if at least one host CPU was found, false otherwise
+*/
+bool HostAffinity::configure() {
+    hostCpus.clear();
+
+#ifdef _WIN32
+    DWORD_PTR processMask, systemMask;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        for (int cpu = 0; cpu < (int)(sizeof(DWORD_PTR) * 8); ++cpu) {
+            if (processMask & ((DWORD_PTR)1 << cpu)) {
+                hostCpus.push_back(cpu);
+            }
+        }
+    }
+#else
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                hostCpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+
+    if (hostCpus.empty()) {
+        cerr << "Error: Could not read the host CPUs, core affinity is disabled.\n";
+        return false;
+    }
+    return true;
+}
+
+bool HostAffinity::isEnabled() const {
+    return !hostCpus.empty();
+}
+
+/*
+* This function returns the host CPU a simulated core is pinned to
+*
+* @param coreID - the simulated core
+* @return the host CPU, or -1 if affinity is disabled
+*/
+int HostAffinity::hostCpuFor(int coreID) const {
+    if (hostCpus.empty()) return -1;
+    return hostCpus[coreID % hostCpus.size()];
+}
+
+/*
+* This function pins the calling thread to the host CPU of a simulated core
+*
+* @param coreID - the simulated core the thread runs
+* @return true if the thread was pinned, false otherwise
+*/
+bool HostAffinity::pinCurrentThread(int coreID) {
+    int cpu = hostCpuFor(coreID);
+    if (cpu < 0) return false;
+
+#ifdef _WIN32
+    bool pinned = SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+#else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    bool pinned = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+
+    if (pinned) {
+        pinnedCount++;
+    }
+    else {
+        failedCount++;
+    }
+    return pinned;
+}
+
+/*
+* This function prints how many core threads were pinned
+*
+* @param out - the stream to print to
+*/
+void HostAffinity::printStats(ostream& out) const {
+    if (hostCpus.empty()) return;
+    out << "Core affinity: " << pinnedCount << " cores pinned across " << hostCpus.size() << " host CPUs";
+    if (failedCount > 0) {
+        out << ", " << failedCount << " failed";
+    }
+    out << endl;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+* Pins simulated cores to host CPUs.
+*
+* The host CPUs this process may run on are read once, and simulated core i is
+* pinned to the i-th of them, wrapping around when there are more simulated
+* cores than host CPUs. Pinning keeps each core worker thread, and so the
+* processes it keeps running, on one host CPU and its caches instead of
+* wherever the OS last found room.
+*/
+class HostAffinity {
+private:
+    vector<int> hostCpus;
+    atomic<int> pinnedCount{ 0 };
+    atomic<int> failedCount{ 0 };
+
+public:
+    bool configure();
+    bool isEnabled() const;
+    int hostCpuFor(int coreID) const;
+    bool pinCurrentThread(int coreID);
+    void printStats(ostream& out) const;
+};
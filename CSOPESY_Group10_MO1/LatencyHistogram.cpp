@@ -0,0 +1,95 @@
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include "LatencyHistogram.h"
+
+/*
+* This function returns the bucket a value falls in. Values below 16 get a
+* bucket each; above that the top set bit picks the power of two and the next
+* four bits pick the sub-bucket.
+*
+* @param value - the value
+* @return the bucket index
+*/
+int LatencyHistogram::bucketOf(uint64_t value) {
+    if (value < SUB_BUCKETS) return (int)value;
+    int highestBit = 63 - countl_zero(value);
+    int shift = highestBit - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + (int)((value >> shift) - SUB_BUCKETS);
+}
+
+/*
+* This function returns the largest value that falls in a bucket
+*
+* @param bucket - the bucket index
+* @return the upper bound of the bucket
+*/
+uint64_t LatencyHistogram::bucketUpperBound(int bucket) {
+    if (bucket < SUB_BUCKETS) return (uint64_t)bucket;
+    int shift = bucket / SUB_BUCKETS - 1;
+    uint64_t mantissa = (uint64_t)(bucket % SUB_BUCKETS + SUB_BUCKETS);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+/*
+* This function records one latency. Negative values count as 0.
+*
+* @param value - the latency in nanoseconds
+*/
+void LatencyHistogram::record(int64_t value) {
+    uint64_t sample = value > 0 ? (uint64_t)value : 0;
+    counts[bucketOf(sample)].fetch_add(1, memory_order_relaxed);
+    total.fetch_add(1, memory_order_relaxed);
+
+    uint64_t currentMax = maxValue.load(memory_order_relaxed);
+    while (sample > currentMax && !maxValue.compare_exchange_weak(currentMax, sample, memory_order_relaxed)) {}
+}
+
+uint64_t LatencyHistogram::count() const {
+    return total.load(memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::max() const {
+    return maxValue.load(memory_order_relaxed);
+}
+
+/*
+* This function returns the value below which the given fraction of the
+* recorded latencies fall
+*
+* @param fraction - the percentile as a fraction, e.g. 0.99
+* @return the latency in nanoseconds, 0 if nothing was recorded
+*/
+uint64_t LatencyHistogram::percentile(double fraction) const {
+    uint64_t recorded = count();
+    if (recorded == 0) return 0;
+
+    uint64_t target = (uint64_t)ceil(fraction * recorded);
+    if (target < 1) target = 1;
+
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        seen += counts[bucket].load(memory_order_relaxed);
+        if (seen >= target) {
+            uint64_t bound = bucketUpperBound(bucket);
+            return bound < max() ? bound : max();
+        }
+    }
+    return max();
+}
+
+/*
+* This function prints the count and the p50, p90, p99, p99.9 and maximum in
+* milliseconds
+*
+* @param out - the stream to print to
+* @param label - the name of the latency
+*/
+void LatencyHistogram::print(ostream& out, const string& label) const {
+    out << "  " << left << setw(14) << label << right << setw(8) << count();
+    const double percentiles[] = { 0.5, 0.9, 0.99, 0.999 };
+    for (double fraction : percentiles) {
+        out << setw(12) << fixed << setprecision(3) << percentile(fraction) / 1e6;
+    }
+    out << setw(12) << fixed << setprecision(3) << max() / 1e6 << endl;
+}
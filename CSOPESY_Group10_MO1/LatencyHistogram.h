@@ -0,0 +1,47 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+/*
+* A log-bucketed latency histogram in the style of HdrHistogram.
+*
+* Every power of two is split into 16 linear sub-buckets, so a recorded value
+* is off by at most 1/16 (6.25%) of itself while nanoseconds up to centuries
+* fit in under a thousand buckets. Recording is a single relaxed fetch_add on
+* the value's bucket, so any number of cores can record at once without a
+* lock. Percentiles are read by walking the buckets and report the upper
+* bound of the bucket the percentile falls in.
+*/
+class LatencyHistogram {
+private:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    array<atomic<uint64_t>, BUCKET_COUNT> counts{};
+    atomic<uint64_t> total{ 0 };
+    atomic<uint64_t> maxValue{ 0 };
+
+    static int bucketOf(uint64_t value);
+    static uint64_t bucketUpperBound(int bucket);
+
+public:
+    void record(int64_t value);
+    uint64_t count() const;
+    uint64_t max() const;
+    uint64_t percentile(double fraction) const;
+    void print(ostream& out, const string& label) const;
+};
+
+// The latencies recorded while one scheduler was running
+struct SchedulingHistograms {
+    LatencyHistogram wait;          // enqueue to dispatch, every time
+    LatencyHistogram requeueWait;   // preemption to the next dispatch
+    LatencyHistogram response;      // arrival to first dispatch
+    LatencyHistogram turnaround;    // arrival to termination
+};
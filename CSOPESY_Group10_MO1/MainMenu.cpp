@@ -6,13 +6,26 @@
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <chrono>
+#include <thread>
 #include "ConsoleManager.h"
 #include "AConsole.h"
+#include "Platform.h"
+#include "ReportWriter.h"
 
 using namespace std;
 
 ConsoleManager consoles;
 bool isInitialized = false;
+bool batchMode = false;
+
+// One line of a batch script
+struct ScriptCommand {
+    int line;
+    bool timed;                 // false runs it right after the previous command
+    chrono::milliseconds at;    // offset from the start of the script
+    vector<string> words;
+};
 
 
 /*
@@ -38,7 +51,7 @@ void displayHeader() {
 * This function clears the console screen
 */
 void clearCommand() {
-    system("cls");
+    clearScreen();
 }
 
 /*
@@ -73,9 +86,14 @@ void screenCommand(const vector<string>& commandBuffer) {
             else {
                 clearCommand();
                 consoles.addConsole(commandBuffer[2], true); // Add new console to console list
-                consoles.loopConsole(commandBuffer[2]); // initialize console program
-                clearCommand();
-                displayHeader();
+
+                // A script has no one to type into the console, so it only
+                // gets the console's details
+                if (!batchMode) {
+                    consoles.loopConsole(commandBuffer[2]); // initialize console program
+                    clearCommand();
+                    displayHeader();
+                }
             }
         }
         // if screen command is "reopen console"
@@ -92,9 +110,11 @@ void screenCommand(const vector<string>& commandBuffer) {
             else {
                 cout << "Reopening console \"" << commandBuffer[2] << "\"\n";
                 consoles.displayConsole(commandBuffer[2]); // Display reopened console
-                consoles.loopConsole(commandBuffer[2]); // Reinitialize console program
-                clearCommand();
-                displayHeader();
+                if (!batchMode) {
+                    consoles.loopConsole(commandBuffer[2]); // Reinitialize console program
+                    clearCommand();
+                    displayHeader();
+                }
             }
         }
         // if screen command syntax is invalid
@@ -124,7 +144,13 @@ void checkCommand(const vector<string>& commandBuffer) {
     }
     else if (command == "exit") {
         cout << command << " command recognized. Thank you! Exiting program.\n";
-        exit(0);
+        ReportWriter::waitForPending();
+        // quick_exit does not flush cout, and the writer thread may have just
+        // printed where its report went
+        cout.flush();
+        // The scheduler and core threads are detached and may be blocked on the
+        // manager's condition variables, so skip the static destructors
+        quick_exit(0);
     }
     else if (!isInitialized) {
         if (command == "initialize") {
@@ -133,7 +159,16 @@ void checkCommand(const vector<string>& commandBuffer) {
             // consoles.testConfig();
             isInitialized = true;
         }
-        else if (command == "screen" || command == "scheduler-test" || command == "scheduler-stop" || command == "report-util") {
+        else if (command == "restore") {
+            if (commandBuffer.size() != 2) {
+                cout << "Usage: restore [file]\n";
+            }
+            else if (consoles.restore(commandBuffer[1])) {
+                cout << "Menu initialized from checkpoint.\n";
+                isInitialized = true;
+            }
+        }
+        else if (command == "screen" || command == "scheduler-test" || command == "scheduler-stop" || command == "report-util" || command == "alloc-stats" || command == "checkpoint" || command == "vmstat" || command == "cpustat") {
             cout << "Please run the \"initialize\" command first\n";
         }
         else {
@@ -160,6 +195,34 @@ void checkCommand(const vector<string>& commandBuffer) {
             cout << "Generating report...\n";
             consoles.reportUtil();
         }
+        else if (command == "alloc-stats") {
+            consoles.allocStats();
+        }
+        else if (command == "vmstat") {
+            consoles.vmstat();
+        }
+        else if (command == "cpustat") {
+            // Optional sampling interval in seconds
+            int seconds = 1;
+            if (commandBuffer.size() == 2) {
+                istringstream argument(commandBuffer[1]);
+                if (!(argument >> seconds)) seconds = 0;
+            }
+            if (commandBuffer.size() > 2 || seconds < 1) {
+                cout << "Usage: cpustat [seconds]\n";
+            }
+            else {
+                consoles.cpustat(seconds);
+            }
+        }
+        else if (command == "checkpoint") {
+            if (commandBuffer.size() != 2) {
+                cout << "Usage: checkpoint [file]\n";
+            }
+            else {
+                consoles.checkpoint(commandBuffer[1]);
+            }
+        }
         else {
             cout << "Command " << command << " not recognized. Please try again.\n";
         }
@@ -167,12 +230,138 @@ void checkCommand(const vector<string>& commandBuffer) {
 
 }
 
-int main() {
+/*
+* This function parses a script time: a number followed by ms, s, m or h, or
+* a bare number of seconds
+*
+* @param text - the time, e.g. 5s, 250ms or 1.5h
+* @param offset - receives the time
+* @return true if the time is valid, false otherwise
+*/
+bool parseScriptTime(const string& text, chrono::milliseconds& offset) {
+    size_t unitStart = text.find_first_not_of("0123456789.");
+    string number = text.substr(0, unitStart);
+    string unit = unitStart == string::npos ? "s" : text.substr(unitStart);
+
+    istringstream in(number);
+    double value;
+    if (number.empty() || !(in >> value) || !in.eof()) return false;
+
+    double milliseconds;
+    if (unit == "ms") milliseconds = value;
+    else if (unit == "s") milliseconds = value * 1000;
+    else if (unit == "m") milliseconds = value * 60 * 1000;
+    else if (unit == "h") milliseconds = value * 60 * 60 * 1000;
+    else return false;
+
+    offset = chrono::milliseconds(llround(milliseconds));
+    return true;
+}
+
+/*
+* This function reads a batch script. Each line is a menu command, optionally
+* prefixed with "at <time>" to run it that long after the script starts.
+* Blank lines and everything after a # are ignored.
+*
+* @param in - the script
+* @param commands - receives the commands in script order
+* @return true if every line is valid, false otherwise
+*/
+bool readScript(istream& in, vector<ScriptCommand>& commands) {
+    string text;
+    int lineNumber = 0;
+    bool valid = true;
+
+    while (getline(in, text)) {
+        lineNumber++;
+        size_t comment = text.find('#');
+        if (comment != string::npos) text.erase(comment);
+
+        istringstream line(text);
+        vector<string> words;
+        string word;
+        while (line >> word) words.push_back(word);
+        if (words.empty()) continue;
+
+        ScriptCommand command = { lineNumber, false, chrono::milliseconds(0), {} };
+        if (words[0] == "at") {
+            if (words.size() < 3 || !parseScriptTime(words[1], command.at)) {
+                cerr << "Error: line " << lineNumber << ": expected 'at <time> <command>', e.g. 'at 5s scheduler-test'\n";
+                valid = false;
+                continue;
+            }
+            command.timed = true;
+            words.erase(words.begin(), words.begin() + 2);
+        }
+        command.words = move(words);
+        commands.push_back(move(command));
+    }
+    return valid;
+}
+
+/*
+* This function runs a batch script, waiting for each timed command's moment,
+* then exits once the last command and any report it asked for are done
+*
+* @param commands - the script's commands
+*/
+void runScript(const vector<ScriptCommand>& commands) {
+    auto start = chrono::steady_clock::now();
+
+    for (const ScriptCommand& command : commands) {
+        if (command.timed) {
+            this_thread::sleep_until(start + command.at);
+        }
+
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "[" << fixed << setprecision(3) << elapsed << "s]";
+        for (const string& word : command.words) cout << " " << word;
+        cout << endl;
+
+        checkCommand(command.words);
+    }
+
+    cout << "Script finished. Exiting program.\n";
+    ReportWriter::waitForPending();
+    cout.flush();
+    quick_exit(0);
+}
+
+int main(int argc, char* argv[]) {
     vector<string> commandBuffer;
     string command;
 
     // consoles.testConfig();
 
+    // --batch [script] runs a script, or the commands piped to stdin, instead
+    // of the interactive menu
+    if (argc > 1) {
+        if (string(argv[1]) != "--batch" || argc > 3) {
+            cerr << "Usage: " << argv[0] << " [--batch [script]]\n";
+            return 2;
+        }
+        batchMode = true;
+        screenClearEnabled = false;
+
+        vector<ScriptCommand> commands;
+        bool valid;
+        if (argc == 3 && string(argv[2]) != "-") {
+            ifstream script(argv[2]);
+            if (!script) {
+                cerr << "Error: Could not open script " << argv[2] << endl;
+                return 1;
+            }
+            valid = readScript(script, commands);
+        }
+        else {
+            valid = readScript(cin, commands);
+        }
+        if (!valid) {
+            return 1;
+        }
+        runScript(commands);
+    }
+
     displayHeader();
 
     while (true) {
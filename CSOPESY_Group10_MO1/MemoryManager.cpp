@@ -0,0 +1,208 @@
+#include <chrono>
+#include <algorithm>
+#include "MemoryManager.h"
+
+/*
+* This function sets the size of memory and of every process's block and
+* marks all of memory as free. A total of 0 disables the memory manager.
+*
+* @param totalMemory - max-overall-mem, in bytes
+* @param memoryPerProcess - mem-per-proc, in bytes
+* @param policy - how a free block is chosen
+*/
+void MemoryManager::configure(uint64_t totalMemory, uint64_t memoryPerProcess, Policy policy) {
+    lock_guard<mutex> lock(memoryMutex);
+
+    this->totalMemory = totalMemory;
+    this->memoryPerProcess = memoryPerProcess;
+    this->policy = policy;
+
+    freeByAddress.clear();
+    freeBySize.clear();
+    allocations.clear();
+    fragmentedBytes = 0;
+    stats = {};
+    stats.totalMemory = totalMemory;
+
+    if (totalMemory > 0) {
+        addFreeBlock(0, totalMemory);
+    }
+}
+
+/*
+* This function checks if memory is being modelled
+*
+* @return true if max-overall-mem was configured, false otherwise
+*/
+bool MemoryManager::isEnabled() const {
+    return totalMemory > 0;
+}
+
+/*
+* This function gives a process its block of memory. A process that already
+* has memory keeps it.
+*
+* @param processID - the process to allocate memory for
+* @return true if the process is in memory, false if no free block is large enough
+*/
+bool MemoryManager::allocate(int processID) {
+    if (totalMemory == 0) return true;
+
+    auto start = chrono::steady_clock::now();
+    lock_guard<mutex> lock(memoryMutex);
+
+    if (allocations.count(processID) != 0) return true;
+
+    map<uint64_t, uint64_t>::iterator block = freeByAddress.end();
+    if (policy == BEST_FIT) {
+        auto fit = freeBySize.lower_bound({ memoryPerProcess, 0 });
+        if (fit != freeBySize.end()) {
+            block = freeByAddress.find(fit->second);
+        }
+    }
+    else {
+        block = find_if(freeByAddress.begin(), freeByAddress.end(), [this](const auto& entry) {
+            return entry.second >= memoryPerProcess;
+        });
+    }
+
+    if (block == freeByAddress.end()) {
+        stats.failedAllocations++;
+        return false;
+    }
+
+    // Carve the process's block from the front of the hole
+    uint64_t blockStart = block->first;
+    uint64_t blockSize = block->second;
+    removeFreeBlock(block);
+    if (blockSize > memoryPerProcess) {
+        addFreeBlock(blockStart + memoryPerProcess, blockSize - memoryPerProcess);
+    }
+    allocations[processID] = { blockStart, memoryPerProcess };
+    stats.usedMemory += memoryPerProcess;
+    stats.allocations++;
+
+    uint64_t latency = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    stats.allocationLatencyTotalNs += latency;
+    stats.allocationLatencyMaxNs = max(stats.allocationLatencyMaxNs, latency);
+    return true;
+}
+
+/*
+* This function returns a process's block to the free space, merging it
+* with any free neighbours
+*
+* @param processID - the process whose memory to free
+* @return true if the process had memory, false otherwise
+*/
+bool MemoryManager::release(int processID) {
+    if (totalMemory == 0) return false;
+
+    lock_guard<mutex> lock(memoryMutex);
+
+    auto allocation = allocations.find(processID);
+    if (allocation == allocations.end()) return false;
+
+    uint64_t start = allocation->second.first;
+    uint64_t size = allocation->second.second;
+    allocations.erase(allocation);
+    stats.usedMemory -= size;
+
+    auto next = freeByAddress.lower_bound(start);
+    if (next != freeByAddress.end() && start + size == next->first) {
+        size += next->second;
+        removeFreeBlock(next);
+    }
+
+    auto previous = freeByAddress.lower_bound(start);
+    if (previous != freeByAddress.begin()) {
+        --previous;
+        if (previous->first + previous->second == start) {
+            start = previous->first;
+            size += previous->second;
+            removeFreeBlock(previous);
+        }
+    }
+
+    addFreeBlock(start, size);
+    releases.fetch_add(1, memory_order_release);
+    return true;
+}
+
+/*
+* This function checks if a process currently has memory
+*
+* @param processID - the process to check
+* @return true if the process is in memory, false otherwise
+*/
+bool MemoryManager::isResident(int processID) const {
+    lock_guard<mutex> lock(memoryMutex);
+    return allocations.count(processID) != 0;
+}
+
+/*
+* This function returns how many blocks have been freed so far. An
+* allocation that failed can only succeed once this has changed.
+*
+* @return the number of releases
+*/
+uint64_t MemoryManager::releaseCount() const {
+    return releases.load(memory_order_acquire);
+}
+
+/*
+* This function samples the number of processes in memory and the external
+* fragmentation. It is called once per quantum.
+*/
+void MemoryManager::recordQuantum() {
+    if (totalMemory == 0) return;
+
+    lock_guard<mutex> lock(memoryMutex);
+    stats.quantumSamples++;
+    stats.sampledProcessesTotal += allocations.size();
+    stats.sampledFragmentationTotal += fragmentedBytes;
+    stats.sampledFragmentationMax = max(stats.sampledFragmentationMax, fragmentedBytes);
+}
+
+/*
+* This function returns the current memory layout and allocation statistics
+*
+* @return stats - the memory statistics
+*/
+MemoryManager::Stats MemoryManager::getStats() const {
+    lock_guard<mutex> lock(memoryMutex);
+
+    Stats current = stats;
+    current.externalFragmentation = fragmentedBytes;
+    current.largestFreeBlock = freeBySize.empty() ? 0 : freeBySize.rbegin()->first;
+    current.freeBlocks = freeByAddress.size();
+    current.processesInMemory = allocations.size();
+    return current;
+}
+
+/*
+* This function adds a hole to both free space indexes
+*
+* @param start - the address of the hole
+* @param size - the size of the hole
+*/
+void MemoryManager::addFreeBlock(uint64_t start, uint64_t size) {
+    freeByAddress[start] = size;
+    freeBySize.insert({ size, start });
+    if (size < memoryPerProcess) {
+        fragmentedBytes += size;
+    }
+}
+
+/*
+* This function removes a hole from both free space indexes
+*
+* @param block - the hole, as an iterator into freeByAddress
+*/
+void MemoryManager::removeFreeBlock(map<uint64_t, uint64_t>::iterator block) {
+    if (block->second < memoryPerProcess) {
+        fragmentedBytes -= block->second;
+    }
+    freeBySize.erase({ block->second, block->first });
+    freeByAddress.erase(block);
+}
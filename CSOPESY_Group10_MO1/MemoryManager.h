@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+/*
+* The emulated main memory.
+*
+* Memory is one flat address range. Every process gets a single contiguous
+* block of mem-per-proc bytes the first time it is dispatched and keeps it
+* until it finishes. Free space is kept as coalesced intervals indexed both
+* by address, for first-fit and for merging neighbours on release, and by
+* size, so best-fit is a single lower_bound. The bytes sitting in holes too
+* small for a process are tracked as blocks are added and removed, so the
+* external fragmentation figure costs nothing to read.
+*/
+class MemoryManager {
+public:
+    enum Policy { FIRST_FIT, BEST_FIT };
+
+    struct Stats {
+        uint64_t totalMemory;
+        uint64_t usedMemory;
+        uint64_t externalFragmentation;
+        uint64_t largestFreeBlock;
+        size_t freeBlocks;
+        size_t processesInMemory;
+        uint64_t allocations;
+        uint64_t failedAllocations;
+        uint64_t allocationLatencyTotalNs;
+        uint64_t allocationLatencyMaxNs;
+        uint64_t quantumSamples;
+        uint64_t sampledProcessesTotal;
+        uint64_t sampledFragmentationTotal;
+        uint64_t sampledFragmentationMax;
+    };
+
+private:
+    uint64_t totalMemory = 0;
+    uint64_t memoryPerProcess = 0;
+    Policy policy = FIRST_FIT;
+
+    map<uint64_t, uint64_t> freeByAddress;          // start -> size
+    set<pair<uint64_t, uint64_t>> freeBySize;       // (size, start)
+    unordered_map<int, pair<uint64_t, uint64_t>> allocations;    // pid -> (start, size)
+    uint64_t fragmentedBytes = 0;
+    Stats stats{};
+    mutable mutex memoryMutex;
+    atomic<uint64_t> releases{ 0 };
+
+    void addFreeBlock(uint64_t start, uint64_t size);
+    void removeFreeBlock(map<uint64_t, uint64_t>::iterator block);
+
+public:
+    void configure(uint64_t totalMemory, uint64_t memoryPerProcess, Policy policy);
+    bool isEnabled() const;
+    bool allocate(int processID);
+    bool release(int processID);
+    bool isResident(int processID) const;
+    uint64_t releaseCount() const;
+    void recordQuantum();
+    Stats getStats() const;
+};
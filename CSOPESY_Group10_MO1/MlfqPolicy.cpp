@@ -0,0 +1,185 @@
+#include <bit>
+#include <climits>
+#include "MlfqPolicy.h"
+
+/*
+* This constructor creates one queue per quantum
+*
+* @param quantums - the quantum of each level, highest priority first
+* @param boostInterval - the number of dispatches between priority boosts, 0 to never boost
+* @param virtualClock - true if times are virtual ticks
+*/
+MlfqPolicy::MlfqPolicy(const vector<int>& quantums, int boostInterval, bool virtualClock)
+    : SchedulerPolicy(virtualClock), levels(quantums.size()), quantums(quantums), stats(quantums.size()), boostInterval(boostInterval) {}
+
+/*
+* This function fills in the quantum of every level. Levels mlfq-quantum does
+* not list double the level above, starting from firstQuantum when none are
+* listed. Doubling saturates at INT_MAX, so deep queues cannot overflow.
+*
+* @param given - the quantums listed in the config, highest priority first
+* @param levelCount - the number of levels
+* @param firstQuantum - the level 0 quantum when none are listed
+* @return one quantum per level
+*/
+vector<int> MlfqPolicy::levelQuantums(const vector<int>& given, int levelCount, int firstQuantum) {
+    vector<int> quantums = given;
+    if (quantums.empty()) {
+        quantums.push_back(firstQuantum);
+    }
+    quantums.resize(levelCount, 0);
+    for (int level = 1; level < levelCount; ++level) {
+        if (quantums[level] == 0) {
+            quantums[level] = quantums[level - 1] > INT_MAX / 2 ? INT_MAX : quantums[level - 1] * 2;
+        }
+    }
+    return quantums;
+}
+
+/*
+* This function appends a process to the queue of its level
+*
+* @param process - the process
+* @param now - the current time
+*/
+void MlfqPolicy::push(AConsole* process, int64_t now) {
+    AConsole::SchedulingInfo& info = process->getSchedulingInfo();
+    info.readyTime = now;
+    levels[info.level].push_back(process);
+    stats[info.level].waiting.store(levels[info.level].size(), memory_order_relaxed);
+    nonEmpty |= 1ull << info.level;
+    queued++;
+}
+
+/*
+* This function admits a new process at the highest priority
+*
+* @param process - the process
+* @param now - the current time
+*/
+void MlfqPolicy::admit(AConsole* process, int64_t now) {
+    AConsole::SchedulingInfo& info = process->getSchedulingInfo();
+    info.level = 0;
+    info.arrivalTime = now;
+    push(process, now);
+}
+
+/*
+* This function puts a process back after a slice, one level lower if it
+* used its whole quantum
+*
+* @param process - the process
+* @param executed - the instructions it ran
+* @param slice - the quantum it was given
+* @param now - the current time
+*/
+void MlfqPolicy::requeue(AConsole* process, int executed, int slice, int64_t now) {
+    AConsole::SchedulingInfo& info = process->getSchedulingInfo();
+    if (executed >= slice && info.level + 1 < (int)levels.size()) {
+        add(stats[info.level].demotions, 1);
+        info.level++;
+    }
+    push(process, now);
+}
+
+/*
+* This function takes the process at the front of the highest non-empty
+* level, boosting every process first if the boost interval has passed
+*
+* @param now - the current time
+* @return the process, or nullptr if no process is runnable
+*/
+AConsole* MlfqPolicy::pickNext(int64_t now) {
+    if (boostInterval > 0 && dispatchesSinceBoost >= boostInterval) {
+        boost();
+    }
+    if (nonEmpty == 0) return nullptr;
+
+    int level = countr_zero(nonEmpty);
+    AConsole* process = levels[level].front();
+    levels[level].pop_front();
+    stats[level].waiting.store(levels[level].size(), memory_order_relaxed);
+    if (levels[level].empty()) {
+        nonEmpty &= ~(1ull << level);
+    }
+    queued--;
+
+    add(stats[level].dispatches, 1);
+    add(stats[level].waitTotal, now - process->getSchedulingInfo().readyTime);
+    dispatchesSinceBoost++;
+    return process;
+}
+
+/*
+* This function returns the quantum of the process's level
+*
+* @param process - the process
+* @return the number of instructions it may run
+*/
+int MlfqPolicy::timeslice(AConsole* process) {
+    return quantums[process->getSchedulingInfo().level];
+}
+
+/*
+* This function records the turnaround of a finished process against the
+* level it finished at
+*
+* @param process - the process
+* @param executed - the instructions it ran in its last slice
+* @param now - the current time
+*/
+void MlfqPolicy::finished(AConsole* process, [[maybe_unused]] int executed, int64_t now) {
+    AConsole::SchedulingInfo& info = process->getSchedulingInfo();
+    add(stats[info.level].finished, 1);
+    add(stats[info.level].turnaroundTotal, now - info.arrivalTime);
+}
+
+/*
+* This function moves every waiting process to level 0, keeping the order of
+* the levels they came from
+*/
+void MlfqPolicy::boost() {
+    for (size_t level = 1; level < levels.size(); ++level) {
+        for (AConsole* process : levels[level]) {
+            process->getSchedulingInfo().level = 0;
+            levels[0].push_back(process);
+        }
+        levels[level].clear();
+        stats[level].waiting.store(0, memory_order_relaxed);
+    }
+    stats[0].waiting.store(levels[0].size(), memory_order_relaxed);
+    nonEmpty = levels[0].empty() ? 0 : 1;
+    dispatchesSinceBoost = 0;
+    add(boosts, 1);
+}
+
+size_t MlfqPolicy::size() const {
+    return queued;
+}
+
+/*
+* This function prints the per-level dispatches, demotions, wait time and
+* turnaround time
+*
+* @param out - the stream to print to
+*/
+void MlfqPolicy::printStats(ostream& out) const {
+    out << "MLFQ priority boosts: " << boosts.load(memory_order_relaxed) << endl;
+    for (size_t level = 0; level < quantums.size(); ++level) {
+        const LevelStats& levelStats = stats[level];
+        uint64_t dispatches = levelStats.dispatches.load(memory_order_relaxed);
+        uint64_t finished = levelStats.finished.load(memory_order_relaxed);
+        out << "Level " << level << " (quantum " << quantums[level] << "): "
+            << levelStats.waiting.load(memory_order_relaxed) << " waiting, "
+            << dispatches << " dispatches, "
+            << levelStats.demotions.load(memory_order_relaxed) << " demoted, "
+            << finished << " finished";
+        if (dispatches > 0) {
+            out << ", avg wait " << formatTime(levelStats.waitTotal.load(memory_order_relaxed) / (double)dispatches);
+        }
+        if (finished > 0) {
+            out << ", avg turnaround " << formatTime(levelStats.turnaroundTotal.load(memory_order_relaxed) / (double)finished);
+        }
+        out << endl;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "SchedulerPolicy.h"
+
+using namespace std;
+
+/*
+* Multi-level feedback queue.
+*
+* Level 0 has the highest priority and the shortest quantum. A process starts
+* at level 0 and drops one level each time it uses its whole quantum, so long
+* CPU-bound processes sink while short ones finish near the top. Every
+* boostInterval dispatches all processes go back to level 0, which keeps the
+* bottom levels from starving.
+*
+* A bitmap has one bit per non-empty level, so the highest-priority process
+* is found with a single count-trailing-zeros instead of a scan of the levels.
+*/
+class MlfqPolicy : public SchedulerPolicy {
+public:
+    static constexpr int MAX_LEVELS = 64;
+
+private:
+    struct LevelStats {
+        atomic<size_t> waiting{ 0 };
+        atomic<uint64_t> dispatches{ 0 };
+        atomic<uint64_t> demotions{ 0 };
+        atomic<uint64_t> finished{ 0 };
+        atomic<int64_t> waitTotal{ 0 };
+        atomic<int64_t> turnaroundTotal{ 0 };
+    };
+
+    vector<deque<AConsole*>> levels;
+    vector<int> quantums;
+    vector<LevelStats> stats;
+    uint64_t nonEmpty = 0;
+    size_t queued = 0;
+    int boostInterval;
+    int dispatchesSinceBoost = 0;
+    atomic<uint64_t> boosts{ 0 };
+
+    void push(AConsole* process, int64_t now);
+    void boost();
+
+public:
+    MlfqPolicy(const vector<int>& quantums, int boostInterval, bool virtualClock);
+
+    static vector<int> levelQuantums(const vector<int>& given, int levelCount, int firstQuantum);
+
+    void admit(AConsole* process, int64_t now) override;
+    void requeue(AConsole* process, int executed, int slice, int64_t now) override;
+    AConsole* pickNext(int64_t now) override;
+    int timeslice(AConsole* process) override;
+    void finished(AConsole* process, int executed, int64_t now) override;
+    size_t size() const override;
+    void printStats(ostream& out) const override;
+};
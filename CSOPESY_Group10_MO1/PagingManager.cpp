@@ -0,0 +1,198 @@
+#include <cstring>
+#include <algorithm>
+#include "PagingManager.h"
+
+PagingManager pagingManager;
+
+/*
+* This function sets up physical memory and the backing store
+*
+* @param totalMemory - max-overall-mem, in bytes
+* @param pageSize - mem-per-frame, in bytes
+* @param memoryPerProcess - mem-per-proc, the size of each address space
+* @param backingFile - the swap file
+* @return true if paging is ready, false if the backing store could not be created
+*/
+bool PagingManager::configure(uint64_t totalMemory, uint32_t pageSize, uint64_t memoryPerProcess, const string& backingFile) {
+    lock_guard<mutex> lock(pagingMutex);
+
+    if (!backingStore.open(backingFile, pageSize)) {
+        return false;
+    }
+
+    this->pageSize = pageSize;
+    frameCount = (uint32_t)(totalMemory / pageSize);
+    pagesPerProcess = (uint32_t)((memoryPerProcess + pageSize - 1) / pageSize);
+    frames = make_unique<Frame[]>(frameCount);
+    // max-overall-mem can be gigabytes, so the buffer is left uninitialized and
+    // the OS only backs the frames that are actually used
+    physicalMemory.reset();
+    physicalMemory = make_unique_for_overwrite<char[]>((size_t)frameCount * pageSize);
+
+    // Hand out low frames first
+    freeFrames.clear();
+    for (uint32_t i = frameCount; i > 0; --i) {
+        freeFrames.push_back(i - 1);
+    }
+    clockHand = 0;
+    startTime = chrono::steady_clock::now();
+    return true;
+}
+
+/*
+* This function checks if demand paging is in use
+*
+* @return true if paging was configured, false otherwise
+*/
+bool PagingManager::isEnabled() const {
+    return frameCount > 0;
+}
+
+/*
+* This function creates the page table of a process with no resident pages
+*
+* @param processID - the process
+* @return the page table, owned by the paging manager until release
+*/
+PagingManager::PageTable* PagingManager::attach(int processID) {
+    auto table = make_unique<PageTable>();
+    table->processID = processID;
+    table->pageCount = pagesPerProcess;
+    table->frames = make_unique<atomic<int32_t>[]>(pagesPerProcess);
+    table->slots = make_unique<int64_t[]>(pagesPerProcess);
+    for (uint32_t i = 0; i < pagesPerProcess; ++i) {
+        table->frames[i].store(-1, memory_order_relaxed);
+        table->slots[i] = -1;
+    }
+
+    lock_guard<mutex> lock(pagingMutex);
+    PageTable* attached = table.get();
+    pageTables[processID] = move(table);
+    return attached;
+}
+
+/*
+* This function frees the frames and backing store slots of a finished
+* process and drops its page table
+*
+* @param processID - the process
+*/
+void PagingManager::release(int processID) {
+    if (frameCount == 0) return;
+
+    lock_guard<mutex> lock(pagingMutex);
+    auto entry = pageTables.find(processID);
+    if (entry == pageTables.end()) return;
+
+    PageTable* table = entry->second.get();
+    for (uint32_t page = 0; page < table->pageCount; ++page) {
+        int32_t frame = table->frames[page].load(memory_order_relaxed);
+        if (frame >= 0) {
+            frames[frame].owner = nullptr;
+            frames[frame].referenced.store(false, memory_order_relaxed);
+            freeFrames.push_back((uint32_t)frame);
+        }
+        if (table->slots[page] >= 0) {
+            backingStore.freeSlot(table->slots[page]);
+        }
+    }
+    retiredAccesses += table->accesses.load(memory_order_relaxed);
+    pageTables.erase(entry);
+}
+
+/*
+* This function loads a page into a frame, evicting another page first if no
+* frame is free
+*
+* @param table - the page table of the faulting process
+* @param page - the page that was touched
+*/
+void PagingManager::pageFault(PageTable* table, uint32_t page) {
+    lock_guard<mutex> lock(pagingMutex);
+    pageFaults++;
+
+    uint32_t frame;
+    if (!freeFrames.empty()) {
+        frame = freeFrames.back();
+        freeFrames.pop_back();
+    }
+    else {
+        frame = selectVictim();
+        Frame& victim = frames[frame];
+        PageTable* owner = victim.owner;
+
+        // Page out. A page keeps its slot once it has one.
+        int64_t& slot = owner->slots[victim.page];
+        if (slot < 0) {
+            slot = backingStore.allocateSlot();
+        }
+        if (slot >= 0) {
+            memcpy(backingStore.slot(slot), &physicalMemory[(size_t)frame * pageSize], pageSize);
+            pagedOut++;
+        }
+        owner->frames[victim.page].store(-1, memory_order_release);
+    }
+
+    char* bytes = &physicalMemory[(size_t)frame * pageSize];
+    if (table->slots[page] >= 0) {
+        memcpy(bytes, backingStore.slot(table->slots[page]), pageSize);
+        pagedIn++;
+    }
+    else {
+        // First touch: a zeroed page tagged with its owner
+        memset(bytes, 0, pageSize);
+        int32_t tag[2] = { table->processID, (int32_t)page };
+        memcpy(bytes, tag, min(sizeof(tag), (size_t)pageSize));
+    }
+
+    frames[frame].owner = table;
+    frames[frame].page = page;
+    frames[frame].referenced.store(true, memory_order_relaxed);
+    table->frames[page].store((int32_t)frame, memory_order_release);
+}
+
+/*
+* This function advances the clock hand to the first frame whose reference
+* bit is clear. It is only called when every frame holds a page, giving
+* every referenced frame a second chance on the way. Every full sweep clears
+* all bits, so the hand moves at most two sweeps and amortized one step per
+* fault.
+*
+* @return the frame to evict
+*/
+uint32_t PagingManager::selectVictim() {
+    while (true) {
+        Frame& candidate = frames[clockHand];
+        uint32_t frame = clockHand;
+        clockHand = (clockHand + 1) % frameCount;
+
+        if (!candidate.referenced.exchange(false, memory_order_relaxed)) {
+            return frame;
+        }
+    }
+}
+
+/*
+* This function returns the frame usage and paging counters
+*
+* @return stats - the paging statistics
+*/
+PagingManager::Stats PagingManager::getStats() const {
+    lock_guard<mutex> lock(pagingMutex);
+
+    Stats stats = {};
+    stats.frameCount = frameCount;
+    stats.framesUsed = frameCount - (uint32_t)freeFrames.size();
+    stats.pageSize = pageSize;
+    stats.accesses = retiredAccesses;
+    for (const auto& entry : pageTables) {
+        stats.accesses += entry.second->accesses.load(memory_order_relaxed);
+    }
+    stats.pageFaults = pageFaults;
+    stats.pagedIn = pagedIn;
+    stats.pagedOut = pagedOut;
+    stats.backingSlotsUsed = backingStore.slotsInUse();
+    stats.backingFileSize = backingStore.fileSize();
+    stats.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    return stats;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "BackingStore.h"
+
+using namespace std;
+
+/*
+* Demand-paged emulated memory.
+*
+* Physical memory is max-overall-mem bytes split into mem-per-frame sized
+* frames. A process's mem-per-proc address space is split into pages of the
+* same size, and nothing is loaded until an instruction touches it. A page
+* table entry holds the frame of a resident page or -1, and is atomic so the
+* core running the process can check it without a lock; only page faults take
+* the paging lock.
+*
+* When no frame is free, a clock hand sweeps the frames, clearing reference
+* bits until it finds a frame that was not used since its last visit. That
+* page is copied to the memory-mapped backing store and its frame reused.
+*/
+class PagingManager {
+public:
+    struct PageTable {
+        int processID;
+        uint32_t pageCount;
+        unique_ptr<atomic<int32_t>[]> frames;   // frame of each page, -1 if not resident
+        unique_ptr<int64_t[]> slots;            // backing store slot, -1 if never paged out
+        atomic<uint64_t> accesses{ 0 };         // written only by the running core
+    };
+
+    struct Stats {
+        uint32_t frameCount;
+        uint32_t framesUsed;
+        uint32_t pageSize;
+        uint64_t accesses;
+        uint64_t pageFaults;
+        uint64_t pagedIn;
+        uint64_t pagedOut;
+        size_t backingSlotsUsed;
+        size_t backingFileSize;
+        double elapsedSeconds;
+    };
+
+private:
+    struct Frame {
+        atomic<bool> referenced{ false };
+        PageTable* owner = nullptr;
+        uint32_t page = 0;
+    };
+
+    uint32_t pageSize = 0;
+    uint32_t frameCount = 0;
+    uint32_t pagesPerProcess = 0;
+    unique_ptr<Frame[]> frames;
+    unique_ptr<char[]> physicalMemory;     // not zeroed; a frame is cleared when a page first lands in it
+    vector<uint32_t> freeFrames;
+    uint32_t clockHand = 0;
+
+    unordered_map<int, unique_ptr<PageTable>> pageTables;
+    BackingStore backingStore;
+    uint64_t pageFaults = 0;
+    uint64_t pagedIn = 0;
+    uint64_t pagedOut = 0;
+    uint64_t retiredAccesses = 0;
+    chrono::steady_clock::time_point startTime;
+    mutable mutex pagingMutex;
+
+    void pageFault(PageTable* table, uint32_t page);
+    uint32_t selectVictim();
+
+public:
+    bool configure(uint64_t totalMemory, uint32_t pageSize, uint64_t memoryPerProcess, const string& backingFile);
+    bool isEnabled() const;
+    PageTable* attach(int processID);
+    void release(int processID);
+    Stats getStats() const;
+
+    /*
+    * This function records an access to a byte of a process's address space
+    * and faults the page in if it is not resident. Only the core running the
+    * process calls it.
+    *
+    * @param table - the page table of the process
+    * @param address - the address that was touched
+    */
+    void access(PageTable* table, uint64_t address) {
+        uint32_t page = (uint32_t)((address / pageSize) % table->pageCount);
+        table->accesses.store(table->accesses.load(memory_order_relaxed) + 1, memory_order_relaxed);
+
+        int32_t frame = table->frames[page].load(memory_order_acquire);
+        if (frame >= 0) {
+            frames[frame].referenced.store(true, memory_order_relaxed);
+            return;
+        }
+        pageFault(table, page);
+    }
+};
+
+extern PagingManager pagingManager;
@@ -0,0 +1,40 @@
+#pragma once
+#include <ctime>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+/*
+* The few calls that differ between the Windows and POSIX builds.
+*/
+
+/*
+* This function converts a calendar time to local time
+*
+* @param time - the calendar time
+* @param localTime - receives the broken-down local time
+*/
+inline void toLocalTime(const time_t& time, tm& localTime) {
+#ifdef _WIN32
+    localtime_s(&localTime, &time);
+#else
+    localtime_r(&time, &localTime);
+#endif
+}
+
+// Batch runs turn clearing off so their output stays one complete log
+inline bool screenClearEnabled = true;
+
+/*
+* This function clears the terminal
+*/
+inline void clearScreen() {
+    if (!screenClearEnabled) return;
+#ifdef _WIN32
+    system("cls");
+#else
+    // Erase the screen and move the cursor home
+    cout << "\033[2J\033[H" << flush;
+#endif
+}
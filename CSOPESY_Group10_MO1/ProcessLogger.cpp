@@ -0,0 +1,213 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <thread>
+#include <unordered_map>
+#include "ProcessLogger.h"
+#include "Platform.h"
+
+ProcessLogger processLogger;
+
+/*
+* This function creates one ring per core and starts the writer thread.
+* Pending records are flushed when the program exits.
+*
+* @param coreCount - the number of cores that will log
+* @param level - which instructions to log
+* @param directory - the directory the log files are written to
+* @param nameLookup - returns the name of a process given its ID
+*/
+void ProcessLogger::start(int coreCount, Level level, const string& directory, function<string(int)> nameLookup) {
+    if (level == OFF || !rings.empty()) return;
+
+    for (int i = 0; i < coreCount; ++i) {
+        rings.push_back(make_unique<Ring>());
+    }
+    this->directory = directory;
+    this->nameLookup = move(nameLookup);
+    cachedTime = time(nullptr);
+
+    error_code error;
+    filesystem::create_directories(directory, error);
+
+    // Set before the scheduler starts any core thread
+    this->level = level;
+
+    thread writerThread(&ProcessLogger::writerLoop, this);
+    writerThread.detach();
+    at_quick_exit([] { processLogger.flush(); });
+}
+
+/*
+* This function appends a record to the ring of the given core, dropping it
+* if the writer has fallen a full ring behind
+*
+* @param coreID - the core whose ring to use
+* @param record - the record to append
+* @return true if the record was appended, false if it was dropped
+*/
+bool ProcessLogger::append(int coreID, const Record& record) {
+    Ring& ring = *rings[(size_t)coreID % rings.size()];
+    size_t tail = ring.tail.load(memory_order_relaxed);
+
+    if (tail - ring.head.load(memory_order_acquire) == RING_SIZE) {
+        ring.dropped.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+    ring.records[tail & (RING_SIZE - 1)] = record;
+    ring.tail.store(tail + 1, memory_order_release);
+    return true;
+}
+
+/*
+* This function is the body of the writer thread. It refreshes the cached
+* clock and drains the rings, sleeping briefly whenever they are empty.
+*/
+void ProcessLogger::writerLoop() {
+    while (true) {
+        cachedTime.store(time(nullptr), memory_order_relaxed);
+        if (drain() == 0) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+}
+
+/*
+* This function writes everything currently in the rings to the log files
+*/
+void ProcessLogger::flush() {
+    if (level == OFF) return;
+    drain();
+}
+
+/*
+* This function formats every record in the rings into per-process buffers
+* and appends each buffer to its log file with a single write. Each process's
+* records are formatted in sequence order; one that arrives early, from the
+* ring of a core the process moved to, waits until the records before it are
+* drained.
+*
+* @return the number of records drained
+*/
+size_t ProcessLogger::drain() {
+    struct PendingLog {
+        string name;
+        string buffer;
+        bool finished = false;
+        uint32_t nextSequence = 0;
+        map<uint32_t, Record> held;
+    };
+
+    // Names are looked up once per process and forgotten when it finishes
+    static unordered_map<int, PendingLog> logs;
+    static vector<pair<int, PendingLog*>> dirty;
+    static int64_t formattedTime = -1;
+    static char timestamp[32];
+
+    auto format = [](PendingLog& log, const Record& record) {
+        // Only format the clock when the second changes
+        if (record.time != formattedTime) {
+            formattedTime = record.time;
+            time_t now = (time_t)record.time;
+            tm localTime;
+            toLocalTime(now, localTime);
+            strftime(timestamp, sizeof(timestamp), "(%m/%d/%Y %H:%M:%S%p)", &localTime);
+        }
+
+        log.buffer += timestamp;
+        log.buffer += " Core:" + to_string(record.coreID) + " ";
+        switch (record.op) {
+        case Program::PRINT:
+            log.buffer += "\"Hello world from " + log.name + "!\"";
+            break;
+        case Program::DECLARE:
+            log.buffer += "DECLARE x" + to_string(record.dst) + " = " + to_string(record.value);
+            break;
+        case Program::ADD:
+            log.buffer += "ADD x" + to_string(record.dst) + " = " + to_string(record.value);
+            break;
+        case Program::SUBTRACT:
+            log.buffer += "SUBTRACT x" + to_string(record.dst) + " = " + to_string(record.value);
+            break;
+        case Program::SLEEP:
+            log.buffer += "SLEEP " + to_string(record.value);
+            break;
+        default:
+            log.buffer += "Finished after " + to_string(record.instructionLine) + " instructions";
+            log.finished = true;
+            break;
+        }
+        log.buffer += '\n';
+        log.nextSequence++;
+    };
+
+    lock_guard<mutex> lock(drainMutex);
+    size_t drained = 0;
+
+    for (auto& ring : rings) {
+        size_t head = ring->head.load(memory_order_relaxed);
+        size_t tail = ring->tail.load(memory_order_acquire);
+
+        for (; head != tail; ++head) {
+            const Record& record = ring->records[head & (RING_SIZE - 1)];
+
+            PendingLog& log = logs[record.processID];
+            if (record.sequence != log.nextSequence) {
+                log.held.emplace(record.sequence, record);
+                continue;
+            }
+
+            if (log.name.empty()) {
+                log.name = nameLookup(record.processID);
+            }
+            if (log.buffer.empty()) {
+                dirty.emplace_back(record.processID, &log);
+            }
+
+            format(log, record);
+            while (!log.held.empty() && log.held.begin()->first == log.nextSequence) {
+                format(log, log.held.begin()->second);
+                log.held.erase(log.held.begin());
+            }
+        }
+
+        drained += tail - ring->head.load(memory_order_relaxed);
+        ring->head.store(tail, memory_order_release);
+    }
+
+    for (auto& [pid, log] : dirty) {
+        ofstream file(directory + "/" + log->name + ".txt", ios::app | ios::binary);
+        file.write(log->buffer.data(), log->buffer.size());
+        log->buffer.clear();
+
+        if (log->finished) {
+            logs.erase(pid);
+        }
+    }
+    dirty.clear();
+
+    written.fetch_add(drained, memory_order_relaxed);
+    return drained;
+}
+
+/*
+* This function prints how many log records were written and dropped
+*
+* @param out - the stream to print to
+*/
+void ProcessLogger::printStats(ostream& out) const {
+    if (level == OFF) return;
+
+    uint64_t dropped = 0;
+    for (const auto& ring : rings) {
+        dropped += ring->dropped.load(memory_order_relaxed);
+    }
+    out << "Log records written: " << written.load(memory_order_relaxed) << endl;
+    out << "Log records dropped: " << dropped << endl;
+}
+
+ProcessLogger::Level ProcessLogger::getLevel() const {
+    return level;
+}
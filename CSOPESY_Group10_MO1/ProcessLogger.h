@@ -0,0 +1,113 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Program.h"
+
+using namespace std;
+
+/*
+* Per-process execution log.
+*
+* Core threads never format text or touch a file. Logging an instruction is a
+* handful of stores into a fixed-size record on the core's own single-producer
+* ring, stamped with a clock the writer thread refreshes, so the hot path has
+* no locks, no system calls and no strftime. When a ring is full the record
+* is dropped and counted instead of making the core wait.
+*
+* A single background writer drains every ring, formats the records into
+* per-process buffers and appends each buffer to logs/<process name>.txt in
+* one write per pass. A process that moves to another core logs to another
+* ring, so records carry a per-process sequence number and the writer holds
+* back any record that arrives before the ones ahead of it.
+*/
+class ProcessLogger {
+public:
+    enum Level { OFF, PRINT, ALL };
+
+    struct Record {
+        int32_t processID;
+        int32_t coreID;
+        uint32_t instructionLine;
+        uint8_t op;         // Program::OpCode, HALT marks a finished process
+        uint8_t dst;
+        uint16_t value;
+        uint32_t sequence;  // per process, counting only records that were kept
+        int64_t time;
+    };
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr size_t RING_SIZE = 1 << 14;
+
+    // Single-producer/single-consumer ring owned by one core
+    struct Ring {
+        unique_ptr<Record[]> records = make_unique<Record[]>(RING_SIZE);
+        alignas(CACHE_LINE) atomic<size_t> tail{ 0 };
+        alignas(CACHE_LINE) atomic<size_t> head{ 0 };
+        atomic<uint64_t> dropped{ 0 };
+    };
+
+    Level level = OFF;
+    string directory;
+    function<string(int)> nameLookup;
+    vector<unique_ptr<Ring>> rings;
+
+    alignas(CACHE_LINE) atomic<int64_t> cachedTime{ 0 };
+    atomic<uint64_t> written{ 0 };
+    mutex drainMutex;
+
+    bool append(int coreID, const Record& record);
+    void writerLoop();
+    size_t drain();
+
+public:
+    void start(int coreCount, Level level, const string& directory, function<string(int)> nameLookup);
+    void flush();
+    void printStats(ostream& out) const;
+
+    /*
+    * This function logs an executed instruction. It is called by the core
+    * that owns the process and returns immediately if the instruction is
+    * filtered out by the log level.
+    *
+    * @param coreID - the core that executed the instruction
+    * @param processID - the process that executed it
+    * @param sequence - the process's log sequence, advanced if the record is kept
+    * @param instructionLine - the process's line after executing it
+    * @param op - the executed Program::OpCode
+    * @param dst - the variable the instruction wrote
+    * @param value - the value written, or the SLEEP ticks
+    */
+    void logInstruction(int coreID, int processID, uint32_t& sequence, uint32_t instructionLine, uint8_t op, uint8_t dst, uint16_t value) {
+        if (level == OFF || (level == PRINT && op != Program::PRINT)) return;
+        if (append(coreID, { processID, coreID, instructionLine, op, dst, value, sequence, cachedTime.load(memory_order_relaxed) })) {
+            sequence++;
+        }
+    }
+
+    /*
+    * This function logs that a process executed its last instruction
+    *
+    * @param coreID - the core that finished the process
+    * @param processID - the finished process
+    * @param sequence - the process's log sequence, advanced if the record is kept
+    * @param instructionLine - the number of instructions executed
+    */
+    void logFinished(int coreID, int processID, uint32_t& sequence, uint32_t instructionLine) {
+        if (level == OFF) return;
+        if (append(coreID, { processID, coreID, instructionLine, Program::HALT, 0, 0, sequence, cachedTime.load(memory_order_relaxed) })) {
+            sequence++;
+        }
+    }
+
+    Level getLevel() const;
+};
+
+extern ProcessLogger processLogger;
@@ -0,0 +1,88 @@
+#include "ProcessStateLists.h"
+
+/*
+* This function detaches a process from whichever list it is on. The caller
+* must hold listsMutex.
+*
+* @param process - the process to detach
+*/
+void ProcessStateLists::unlink(AConsole* process) {
+    if (process->listIndex < 0) return;
+
+    List& list = lists[process->listIndex];
+    if (process->listPrev != nullptr) process->listPrev->listNext = process->listNext;
+    else list.head = process->listNext;
+    if (process->listNext != nullptr) process->listNext->listPrev = process->listPrev;
+    else list.tail = process->listPrev;
+
+    list.count--;
+    process->listPrev = nullptr;
+    process->listNext = nullptr;
+    process->listIndex = -1;
+}
+
+/*
+* This function appends a process to the end of a list. The caller must hold
+* listsMutex and the process must not be on any list.
+*
+* @param process - the process to append
+* @param listIndex - the list to append it to
+*/
+void ProcessStateLists::append(AConsole* process, int listIndex) {
+    List& list = lists[listIndex];
+    process->listPrev = list.tail;
+    process->listNext = nullptr;
+    if (list.tail != nullptr) list.tail->listNext = process;
+    else list.head = process;
+    list.tail = process;
+
+    list.count++;
+    process->listIndex = listIndex;
+}
+
+/*
+* This function moves a process to the end of the list for its new state
+*
+* @param process - the process that changed state
+* @param status - the state it changed to
+*/
+void ProcessStateLists::move(AConsole* process, AConsole::Status status) {
+    lock_guard<mutex> lock(listsMutex);
+    unlink(process);
+    append(process, status);
+}
+
+/*
+* This function appends a batch of new processes, which are on no list yet,
+* to the list for their state under one acquisition of the lock
+*
+* @param processes - the processes, in the order to append them
+* @param count - the number of processes
+* @param status - their state
+*/
+void ProcessStateLists::appendBatch(AConsole* const* processes, size_t count, AConsole::Status status) {
+    lock_guard<mutex> lock(listsMutex);
+    for (size_t i = 0; i < count; ++i) {
+        append(processes[i], status);
+    }
+}
+
+/*
+* This function takes a process off the state lists, before it is reaped
+*
+* @param process - the process to remove
+*/
+void ProcessStateLists::remove(AConsole* process) {
+    lock_guard<mutex> lock(listsMutex);
+    unlink(process);
+}
+
+/*
+* This function returns the number of processes in the given state
+*
+* @param status - the state to count
+* @return the number of processes in that state
+*/
+size_t ProcessStateLists::count(AConsole::Status status) const {
+    return lists[status].count;
+}
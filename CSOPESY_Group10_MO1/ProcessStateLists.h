@@ -0,0 +1,70 @@
+#pragma once
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include "AConsole.h"
+
+using namespace std;
+
+/*
+* Intrusive lists of processes grouped by state (waiting, running, finished).
+*
+* The link fields live inside AConsole, so moving a process between lists is
+* a constant-time unlink/append with no allocation. Each list keeps an atomic
+* count that can be read without the lock, and walking a list only touches
+* the processes in that state, so listing the running set does not depend on
+* how many processes have finished.
+*/
+class ProcessStateLists {
+private:
+    static constexpr int LIST_COUNT = 3;
+
+    struct List {
+        AConsole* head = nullptr;
+        AConsole* tail = nullptr;
+        atomic<size_t> count{ 0 };
+    };
+
+    List lists[LIST_COUNT];
+    mutable mutex listsMutex;
+
+    void unlink(AConsole* process);
+    void append(AConsole* process, int listIndex);
+
+public:
+    void move(AConsole* process, AConsole::Status status);
+    void appendBatch(AConsole* const* processes, size_t count, AConsole::Status status);
+    void remove(AConsole* process);
+    size_t count(AConsole::Status status) const;
+
+    /*
+    * This function calls fn on every process in the given state, oldest
+    * transition first, while holding the lists' lock
+    *
+    * @param status - the state whose list to walk
+    * @param fn - a callable taking an AConsole*
+    */
+    template <typename Fn>
+    void forEach(AConsole::Status status, Fn fn) const {
+        lock_guard<mutex> lock(listsMutex);
+        for (AConsole* process = lists[status].head; process != nullptr; process = process->listNext) {
+            fn(process);
+        }
+    }
+
+    /*
+    * This function calls fn on every process in every list under a single
+    * acquisition of the lock, so the result is one consistent view
+    *
+    * @param fn - a callable taking an AConsole::Status and an AConsole*
+    */
+    template <typename Fn>
+    void forEachState(Fn fn) const {
+        lock_guard<mutex> lock(listsMutex);
+        for (int status = 0; status < LIST_COUNT; ++status) {
+            for (AConsole* process = lists[status].head; process != nullptr; process = process->listNext) {
+                fn((AConsole::Status)status, process);
+            }
+        }
+    }
+};
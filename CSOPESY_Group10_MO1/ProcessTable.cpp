@@ -0,0 +1,284 @@
+#include <functional>
+#include <algorithm>
+#include "ProcessTable.h"
+
+ProcessTable::ProcessTable() : nameBuckets(64, EMPTY) {}
+
+/*
+* This function returns the bucket that holds the given name, or the empty
+* bucket where it would be inserted. The caller must hold tableMutex.
+*
+* @param name - the process name to look for
+* @param hash - the hash of name
+* @return the index of the matching or first empty bucket
+*/
+size_t ProcessTable::findBucket(const string& name, size_t hash) const {
+    size_t mask = nameBuckets.size() - 1;
+    size_t bucket = hash & mask;
+
+    while (nameBuckets[bucket] != EMPTY) {
+        uint32_t slot = nameBuckets[bucket] - 1;
+        if (slotHashes[slot] == hash && slots[slot]->hasName(name)) {
+            break;
+        }
+        bucket = (bucket + 1) & mask;
+    }
+    return bucket;
+}
+
+/*
+* This function places a slot in the first empty bucket of its probe sequence.
+* The caller must hold tableMutex for writing.
+*
+* @param slot - the slot to index
+* @param hash - the hash of the slot's name
+*/
+void ProcessTable::insertBucket(uint32_t slot, size_t hash) {
+    size_t mask = nameBuckets.size() - 1;
+    size_t bucket = hash & mask;
+
+    while (nameBuckets[bucket] != EMPTY) {
+        bucket = (bucket + 1) & mask;
+    }
+    nameBuckets[bucket] = slot + 1;
+}
+
+/*
+* This function empties a bucket and shifts the rest of its cluster back so
+* linear probing never hits a false gap. The caller must hold tableMutex for
+* writing.
+*
+* @param bucket - the bucket to empty
+*/
+void ProcessTable::eraseBucket(size_t bucket) {
+    size_t mask = nameBuckets.size() - 1;
+    size_t hole = bucket;
+    size_t next = (hole + 1) & mask;
+
+    while (nameBuckets[next] != EMPTY) {
+        size_t home = slotHashes[nameBuckets[next] - 1] & mask;
+
+        // Move the entry back if the hole lies between its home and where it sits
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            nameBuckets[hole] = nameBuckets[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    nameBuckets[hole] = EMPTY;
+}
+
+/*
+* This function resizes the hash index and reinserts every slot. The caller
+* must hold tableMutex for writing.
+*
+* @param bucketCount - the new number of buckets, a power of two
+*/
+void ProcessTable::rehash(size_t bucketCount) {
+    nameBuckets.assign(bucketCount, EMPTY);
+    for (uint32_t slot = 0; slot < slots.size(); ++slot) {
+        if (!slots[slot]->hasGeneratedName()) {
+            insertBucket(slot, slotHashes[slot]);
+        }
+    }
+}
+
+/*
+* This function points a PID at its slot, growing the PID index if needed.
+* The caller must hold tableMutex for writing.
+*
+* @param slot - the slot
+* @param pid - the process ID of the process in the slot
+*/
+void ProcessTable::indexPid(uint32_t slot, int pid) {
+    if ((size_t)pid >= pidIndex.size()) {
+        pidIndex.resize(max((size_t)pid + 1, pidIndex.size() * 2), EMPTY);
+    }
+    pidIndex[pid] = slot + 1;
+}
+
+/*
+* This function looks up a process whose name is derived from its PID. The
+* caller must hold tableMutex.
+*
+* @param name - the name of the process
+* @return the process, or nullptr if no such process has that name
+*/
+AConsole* ProcessTable::findGenerated(const string& name) const {
+    int pid = AConsole::pidForName(name);
+    if (pid < 0 || (size_t)pid >= pidIndex.size() || pidIndex[pid] == EMPTY) {
+        return nullptr;
+    }
+    AConsole* console = slots[pidIndex[pid] - 1];
+    return console->hasGeneratedName() ? console : nullptr;
+}
+
+/*
+* This function adds a process to the table
+*
+* @param console - the process to add
+* @return true if it was added, false if a process with that name exists
+*/
+bool ProcessTable::insert(AConsole* console) {
+    size_t hash = std::hash<string>{}(console->getName());
+
+    unique_lock<shared_mutex> lock(tableMutex);
+
+    if (nameBuckets[findBucket(console->getName(), hash)] != EMPTY || findGenerated(console->getName()) != nullptr) {
+        return false;
+    }
+
+    // Keep the hash index at most half full so probe sequences stay short
+    if ((namedCount + 1) * 2 > nameBuckets.size()) {
+        rehash(nameBuckets.size() * 2);
+    }
+
+    uint32_t slot = (uint32_t)slots.size();
+    slots.push_back(console);
+    slotHashes.push_back(hash);
+    insertBucket(slot, hash);
+    namedCount++;
+    if (AConsole::pidForName(console->getName()) >= 0) pidFormNames++;
+    indexPid(slot, console->getProcessID());
+
+    return true;
+}
+
+/*
+* This function adds a batch of processes whose names are derived from their
+* PIDs under one acquisition of the lock. PIDs are unique, so derived names
+* only need checking against stored names, and only while some stored name
+* has the same form.
+*
+* @param consoles - the processes to add; the ones left out are moved to the
+*                   end, keeping their order
+* @param count - the number of processes
+* @return the number of processes added, from the front of consoles
+*/
+size_t ProcessTable::insertGenerated(AConsole** consoles, size_t count) {
+    unique_lock<shared_mutex> lock(tableMutex);
+
+    size_t added = 0;
+    vector<AConsole*> rejected;
+    for (size_t i = 0; i < count; ++i) {
+        AConsole* console = consoles[i];
+        if (pidFormNames > 0) {
+            string name = console->getName();
+            if (nameBuckets[findBucket(name, std::hash<string>{}(name))] != EMPTY) {
+                rejected.push_back(console);
+                continue;
+            }
+        }
+
+        uint32_t slot = (uint32_t)slots.size();
+        slots.push_back(console);
+        slotHashes.push_back(0);
+        indexPid(slot, console->getProcessID());
+        consoles[added++] = console;
+    }
+    copy(rejected.begin(), rejected.end(), consoles + added);
+    return added;
+}
+
+/*
+* This function looks up a process by name
+*
+* @param name - the name of the process
+* @return the process, or nullptr if there is none with that name
+*/
+AConsole* ProcessTable::find(const string& name) const {
+    size_t hash = std::hash<string>{}(name);
+
+    shared_lock<shared_mutex> lock(tableMutex);
+    uint32_t entry = nameBuckets[findBucket(name, hash)];
+    return entry == EMPTY ? findGenerated(name) : slots[entry - 1];
+}
+
+/*
+* This function looks up a process by its process ID
+*
+* @param pid - the process ID
+* @return the process, or nullptr if there is none with that ID
+*/
+AConsole* ProcessTable::findByPid(int pid) const {
+    shared_lock<shared_mutex> lock(tableMutex);
+    if (pid < 0 || (size_t)pid >= pidIndex.size() || pidIndex[pid] == EMPTY) {
+        return nullptr;
+    }
+    return slots[pidIndex[pid] - 1];
+}
+
+/*
+* This function removes a process from the table. The last slot is moved into
+* the freed one so the array stays dense.
+*
+* @param pid - the process ID of the process to remove
+* @return the removed process, or nullptr if there is none with that ID
+*/
+AConsole* ProcessTable::remove(int pid) {
+    unique_lock<shared_mutex> lock(tableMutex);
+    if (pid < 0 || (size_t)pid >= pidIndex.size() || pidIndex[pid] == EMPTY) {
+        return nullptr;
+    }
+
+    uint32_t slot = pidIndex[pid] - 1;
+    AConsole* removed = slots[slot];
+    if (!removed->hasGeneratedName()) {
+        eraseBucket(findBucket(removed->getName(), slotHashes[slot]));
+        namedCount--;
+        if (AConsole::pidForName(removed->getName()) >= 0) pidFormNames--;
+    }
+    pidIndex[pid] = EMPTY;
+
+    uint32_t last = (uint32_t)slots.size() - 1;
+    if (slot != last) {
+        AConsole* moved = slots[last];
+        if (!moved->hasGeneratedName()) {
+            nameBuckets[findBucket(moved->getName(), slotHashes[last])] = slot + 1;
+        }
+
+        slots[slot] = moved;
+        slotHashes[slot] = slotHashes[last];
+        pidIndex[moved->getProcessID()] = slot + 1;
+    }
+    slots.pop_back();
+    slotHashes.pop_back();
+
+    return removed;
+}
+
+/*
+* This function preallocates room for the given number of processes
+*
+* @param count - the number of processes the table should hold without growing
+*/
+void ProcessTable::reserve(size_t count) {
+    unique_lock<shared_mutex> lock(tableMutex);
+    slots.reserve(count);
+    slotHashes.reserve(count);
+
+    size_t buckets = nameBuckets.size();
+    while (count * 2 > buckets) buckets *= 2;
+    if (buckets != nameBuckets.size()) {
+        rehash(buckets);
+    }
+}
+
+/*
+* This function returns the number of processes in the table
+*
+* @return the number of processes
+*/
+size_t ProcessTable::size() const {
+    shared_lock<shared_mutex> lock(tableMutex);
+    return slots.size();
+}
+
+/*
+* This function checks whether the table holds any process
+*
+* @return true if the table is empty, false otherwise
+*/
+bool ProcessTable::empty() const {
+    return size() == 0;
+}
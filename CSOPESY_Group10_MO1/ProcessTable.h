@@ -0,0 +1,71 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <shared_mutex>
+#include <mutex>
+#include "AConsole.h"
+
+using namespace std;
+
+/*
+* The table of every process known to the emulator.
+*
+* Processes are kept in a dense, slot-indexed array so iterating over them is
+* a linear walk. Two flat indexes sit beside it: an open-addressing hash table
+* from name to slot and a direct array from PID to slot. Both lookups are
+* O(1) and neither index allocates per entry. Removal swaps the last slot into
+* the hole, so slots stay dense.
+*
+* Processes admitted in bulk have names derived from their PID and stay out of
+* the name index; looking one up by name parses the PID back out of it. A
+* derived name never duplicates a stored one: each insert checks the other.
+*
+* The table has its own reader/writer lock, so lookups from the menu thread
+* never wait on the scheduler's processMutex.
+*/
+class ProcessTable {
+private:
+    static constexpr uint32_t EMPTY = 0;
+
+    vector<AConsole*> slots;
+    vector<size_t> slotHashes;
+    vector<uint32_t> nameBuckets;    // slot + 1, or EMPTY
+    vector<uint32_t> pidIndex;       // slot + 1, or EMPTY
+    size_t namedCount = 0;           // slots in nameBuckets
+    size_t pidFormNames = 0;         // named slots whose name looks like a PID name
+    mutable shared_mutex tableMutex;
+
+    size_t findBucket(const string& name, size_t hash) const;
+    void insertBucket(uint32_t slot, size_t hash);
+    void eraseBucket(size_t bucket);
+    void rehash(size_t bucketCount);
+    void indexPid(uint32_t slot, int pid);
+    AConsole* findGenerated(const string& name) const;
+
+public:
+    ProcessTable();
+
+    bool insert(AConsole* console);
+    size_t insertGenerated(AConsole** consoles, size_t count);
+    AConsole* find(const string& name) const;
+    AConsole* findByPid(int pid) const;
+    AConsole* remove(int pid);
+    void reserve(size_t count);
+    size_t size() const;
+    bool empty() const;
+
+    /*
+    * This function calls fn on every process, in slot order, while holding
+    * the table's read lock
+    *
+    * @param fn - a callable taking an AConsole*
+    */
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        shared_lock<shared_mutex> lock(tableMutex);
+        for (AConsole* console : slots) {
+            fn(console);
+        }
+    }
+};
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include "Program.h"
+
+/*
+* This function returns a random value in [low, high]. Unlike
+* FastRandom::between the range can exceed 32 bits.
+*
+* @param rng - the generator
+* @param low - the smallest value
+* @param high - the largest value
+* @return the random value
+*/
+static uint64_t randomBetween(FastRandom& rng, uint64_t low, uint64_t high) {
+    return low + rng.next() % (high - low + 1);
+}
+
+/*
+* This function generates a random program that executes exactly the given
+* number of instructions
+*
+* @param instructionCount - the number of instructions the program executes
+* @param seed - the generator seed; the same seed always yields the same program
+* @return the compiled program
+*/
+Program Program::generate(uint64_t instructionCount, uint64_t seed) {
+    Program program;
+    FastRandom rng(seed);
+    program.emitBody(instructionCount, 0, rng);
+    program.code.push_back({ HALT, 0, 0, 0, 0, 0 });
+    return program;
+}
+
+/*
+* This function emits a sequence of instructions that executes exactly count
+* instructions. Loops are sized so that the innermost body holds at most 8
+* instructions and each enclosing level at most 8 times more, which keeps the
+* compiled code small even for very long programs.
+*
+* @param count - the number of instructions to execute
+* @param depth - the current loop nesting depth
+* @param rng - the generator
+*/
+void Program::emitBody(uint64_t count, int depth, FastRandom& rng) {
+    while (count > 0) {
+        if (depth == MAX_LOOP_DEPTH || count < 4 || rng.next() % 4 == 0) {
+            emitSimple(rng);
+            count--;
+            continue;
+        }
+
+        uint64_t bodyCap = 1ull << (3 * (MAX_LOOP_DEPTH - depth));
+        uint64_t body = randomBetween(rng, 1, min(bodyCap, count / 2));
+        uint64_t maxRepeats = min<uint64_t>(count / body, UINT16_MAX);
+        uint64_t repeats = randomBetween(rng, max<uint64_t>(2, maxRepeats / 2), maxRepeats);
+
+        size_t bodyStart = code.size() + 1;
+        code.push_back({ LOOP_BEGIN, 0, 0, 0, (uint16_t)repeats, 0 });
+        emitBody(body, depth + 1, rng);
+
+        // LOOP_END jumps back by a relative offset; bodies are bounded by
+        // bodyCap so the offset always fits
+        code.push_back({ LOOP_END, 0, 0, 0, 0, (uint16_t)(code.size() - bodyStart) });
+        count -= body * repeats;
+    }
+}
+
+/*
+* This function emits one randomly chosen non-loop instruction
+*
+* @param rng - the generator
+*/
+void Program::emitSimple(FastRandom& rng) {
+    uint64_t r = rng.next();
+    Instruction instruction = {};
+    instruction.dst = (uint8_t)(r % MAX_VARIABLES);
+
+    uint64_t choice = (r >> 8) % 10;
+    if (choice < 2) {
+        instruction.op = PRINT;
+    }
+    else if (choice < 4) {
+        instruction.op = DECLARE;
+        instruction.lhs = (uint16_t)((r >> 16) & 0xFF);
+    }
+    else if (choice < 9) {
+        instruction.op = choice < 7 ? ADD : SUBTRACT;
+        instruction.flags = (uint8_t)((r >> 16) & (LHS_IMMEDIATE | RHS_IMMEDIATE));
+        instruction.lhs = (uint16_t)((instruction.flags & LHS_IMMEDIATE) ? (r >> 24) & 0xFF : (r >> 24) % MAX_VARIABLES);
+        instruction.rhs = (uint16_t)((instruction.flags & RHS_IMMEDIATE) ? (r >> 32) & 0xFF : (r >> 32) % MAX_VARIABLES);
+    }
+    else {
+        instruction.op = SLEEP;
+        instruction.lhs = (uint16_t)(1 + (r >> 16) % 4);
+    }
+    code.push_back(instruction);
+}
+
+/*
+* This function interprets the program until budget instructions have been
+* executed, a SLEEP has been executed or the program has finished. Each
+* handler jumps straight to the next one: through a table of label addresses
+* on GCC/Clang and through a switch elsewhere.
+*
+* @param state - the interpreter registers of the process
+* @param budget - the maximum number of instructions to execute
+* @return the number of instructions executed
+*/
+uint64_t Program::run(State& state, uint64_t budget) const {
+    state.sleepTicks = 0;
+    if (budget == 0 || code.empty()) return 0;
+
+    const Instruction* base = code.data();
+    const Instruction* ip = base + state.pc;
+    uint16_t* variables = state.variables;
+    uint32_t depth = state.depth;
+    uint64_t executed = 0;
+    uint32_t lhs;
+    uint32_t rhs;
+
+#if defined(__GNUC__)
+    static void* const handlers[] = {
+        &&op_print, &&op_declare, &&op_add, &&op_subtract, &&op_sleep, &&op_loop_begin, &&op_loop_end, &&op_halt
+    };
+#define NEXT() goto *handlers[ip->op]
+#else
+#define NEXT() goto dispatch
+#endif
+
+#define RETIRE() if (++executed == budget) goto done; NEXT()
+
+    NEXT();
+
+#if !defined(__GNUC__)
+dispatch:
+    switch (ip->op) {
+    case PRINT: goto op_print;
+    case DECLARE: goto op_declare;
+    case ADD: goto op_add;
+    case SUBTRACT: goto op_subtract;
+    case SLEEP: goto op_sleep;
+    case LOOP_BEGIN: goto op_loop_begin;
+    case LOOP_END: goto op_loop_end;
+    default: goto op_halt;
+    }
+#endif
+
+op_print:
+    state.lastOp = PRINT;
+    state.printCount++;
+    ip++;
+    RETIRE();
+
+op_declare:
+    state.lastOp = DECLARE;
+    state.lastDst = ip->dst;
+    variables[ip->dst] = ip->lhs;
+    ip++;
+    RETIRE();
+
+op_add:
+    state.lastOp = ADD;
+    state.lastDst = ip->dst;
+    lhs = (ip->flags & LHS_IMMEDIATE) ? ip->lhs : variables[ip->lhs];
+    rhs = (ip->flags & RHS_IMMEDIATE) ? ip->rhs : variables[ip->rhs];
+    variables[ip->dst] = (uint16_t)min<uint32_t>(lhs + rhs, UINT16_MAX);
+    ip++;
+    RETIRE();
+
+op_subtract:
+    state.lastOp = SUBTRACT;
+    state.lastDst = ip->dst;
+    lhs = (ip->flags & LHS_IMMEDIATE) ? ip->lhs : variables[ip->lhs];
+    rhs = (ip->flags & RHS_IMMEDIATE) ? ip->rhs : variables[ip->rhs];
+    variables[ip->dst] = (uint16_t)(lhs > rhs ? lhs - rhs : 0);
+    ip++;
+    RETIRE();
+
+op_sleep:
+    // Hand the core back so the caller can stall for the requested ticks
+    state.lastOp = SLEEP;
+    state.sleepTicks = ip->lhs;
+    ip++;
+    executed++;
+    goto done;
+
+op_loop_begin:
+    state.loopRemaining[depth++] = ip->lhs;
+    ip++;
+    NEXT();
+
+op_loop_end:
+    if (--state.loopRemaining[depth - 1] > 0) {
+        ip -= ip->rhs;
+    }
+    else {
+        depth--;
+        ip++;
+    }
+    NEXT();
+
+op_halt:
+done:
+    state.pc = (uint32_t)(ip - base);
+    state.depth = depth;
+    return executed;
+
+#undef RETIRE
+#undef NEXT
+}
+
+/*
+* This function fast-forwards the interpreter past count instructions without
+* sleeping, used to rebuild the registers of a restored process
+*
+* @param state - the interpreter registers of the process
+* @param count - the number of instructions to skip
+* @return the number of instructions skipped
+*/
+uint64_t Program::skip(State& state, uint64_t count) const {
+    uint64_t skipped = 0;
+    while (skipped < count) {
+        uint64_t executed = run(state, count - skipped);
+        if (executed == 0) break;
+        skipped += executed;
+    }
+    state.sleepTicks = 0;
+    return skipped;
+}
+
+bool Program::empty() const {
+    return code.empty();
+}
+
+size_t Program::size() const {
+    return code.size();
+}
+
+/*
+* This function releases the compiled code once the process has finished
+*/
+void Program::clear() {
+    vector<Instruction>().swap(code);
+}
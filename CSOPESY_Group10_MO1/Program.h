@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "FastRandom.h"
+
+using namespace std;
+
+/*
+* A process body compiled to bytecode.
+*
+* Programs are generated from PRINT, DECLARE, ADD, SUBTRACT, SLEEP and FOR
+* instructions, with FOR loops nested up to MAX_LOOP_DEPTH levels. Each
+* instruction is encoded in 8 bytes; FOR is compiled to a LOOP_BEGIN/LOOP_END
+* pair whose jump targets are resolved at generation time, so the interpreter
+* never searches for a matching end. Loop control is not counted as an
+* executed instruction, which makes the number of executed instructions of a
+* program exactly the instruction total it was generated for.
+*/
+class Program {
+public:
+    enum OpCode : uint8_t { PRINT, DECLARE, ADD, SUBTRACT, SLEEP, LOOP_BEGIN, LOOP_END, HALT };
+
+    // Operand flags: the operand is an immediate value instead of a variable
+    static constexpr uint8_t LHS_IMMEDIATE = 1;
+    static constexpr uint8_t RHS_IMMEDIATE = 2;
+
+    static constexpr int MAX_VARIABLES = 32;
+    static constexpr int MAX_LOOP_DEPTH = 3;
+
+    // The variables are laid out at the start of a process's address space,
+    // followed by the code
+    static constexpr uint64_t SYMBOL_TABLE_SIZE = MAX_VARIABLES * sizeof(uint16_t);
+
+    struct Instruction {
+        uint8_t op;
+        uint8_t flags;
+        uint8_t dst;        // destination variable
+        uint8_t reserved;
+        uint16_t lhs;       // variable, immediate, SLEEP ticks or loop repeats
+        uint16_t rhs;       // variable, immediate or loop jump target
+    };
+
+    // Interpreter registers. Kept outside Program so the code can be shared
+    // or regenerated without losing the position of a running process.
+    struct State {
+        uint32_t pc = 0;
+        uint32_t depth = 0;
+        uint16_t loopRemaining[MAX_LOOP_DEPTH] = {};
+        uint16_t variables[MAX_VARIABLES] = {};
+        uint32_t printCount = 0;
+        uint32_t sleepTicks = 0;    // ticks requested by the last SLEEP
+        uint8_t lastOp = HALT;      // the last executed instruction
+        uint8_t lastDst = 0;        // and the variable it wrote, for logging
+    };
+
+private:
+    vector<Instruction> code;
+
+    void emitBody(uint64_t count, int depth, FastRandom& rng);
+    void emitSimple(FastRandom& rng);
+
+public:
+    static Program generate(uint64_t instructionCount, uint64_t seed);
+
+    uint64_t run(State& state, uint64_t budget) const;
+    uint64_t skip(State& state, uint64_t count) const;
+
+    bool empty() const;
+    size_t size() const;
+    void clear();
+};
@@ -0,0 +1,168 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+using namespace std;
+
+/*
+* A bounded lock-free multi-producer/multi-consumer ring queue.
+*
+* Every cell carries a sequence number that tells producers and consumers
+* whether the cell is free for the current lap around the ring. A producer
+* claims a slot by advancing tail with a CAS, writes the value and then
+* publishes it by bumping the cell's sequence; consumers do the same with
+* head. No operation ever blocks, so a full or empty queue is reported by
+* tryPush/tryPop returning false.
+*
+* The capacity is rounded up to a power of two so the slot index is a mask.
+*/
+template <typename T>
+class ReadyQueue {
+private:
+    struct Cell {
+        atomic<size_t> sequence;
+        T value;
+    };
+
+    // Keep the producer and consumer cursors on separate cache lines
+    static constexpr size_t CACHE_LINE = 64;
+
+    unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(CACHE_LINE) atomic<size_t> tail{ 0 };
+    alignas(CACHE_LINE) atomic<size_t> head{ 0 };
+
+public:
+    explicit ReadyQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+
+        cells = make_unique<Cell[]>(size);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, memory_order_relaxed);
+        }
+    }
+
+    ReadyQueue(const ReadyQueue&) = delete;
+    ReadyQueue& operator=(const ReadyQueue&) = delete;
+
+    /*
+    * This function appends a value to the back of the queue
+    *
+    * @param value - the value to enqueue
+    * @return true if the value was enqueued, false if the queue is full
+    */
+    bool tryPush(const T& value) {
+        size_t pos = tail.load(memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = tail.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    /*
+    * This function appends as many of the values as fit with a single CAS on
+    * tail, so a batch is published in one step and stays contiguous. A
+    * claimed cell whose consumer has not finished with it yet is waited for;
+    * the consumer already holds it, so the wait is short.
+    *
+    * @param values - the values to enqueue, in order
+    * @param count - the number of values
+    * @return the number of values enqueued, from the front of values
+    */
+    size_t tryPushBulk(const T* values, size_t count) {
+        size_t pos = tail.load(memory_order_relaxed);
+        size_t claimed;
+        while (true) {
+            size_t front = head.load(memory_order_acquire);
+            if (front > pos) {
+                // Consumers passed a stale tail
+                pos = tail.load(memory_order_relaxed);
+                continue;
+            }
+
+            size_t queued = pos - front;
+            size_t room = queued < mask + 1 ? mask + 1 - queued : 0;
+            claimed = count < room ? count : room;
+            if (claimed == 0) return 0;
+            if (tail.compare_exchange_weak(pos, pos + claimed, memory_order_relaxed)) break;
+        }
+
+        for (size_t i = 0; i < claimed; ++i) {
+            Cell& cell = cells[(pos + i) & mask];
+            while (cell.sequence.load(memory_order_acquire) != pos + i) {
+                // The cell's consumer from the previous lap is still reading it
+            }
+            cell.value = values[i];
+            cell.sequence.store(pos + i + 1, memory_order_release);
+        }
+        return claimed;
+    }
+
+    /*
+    * This function removes the value at the front of the queue
+    *
+    * @param value - receives the dequeued value
+    * @return true if a value was dequeued, false if the queue is empty
+    */
+    bool tryPop(T& value) {
+        size_t pos = head.load(memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.sequence.store(pos + mask + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = head.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    /*
+    * This function returns the number of queued values. The result is only a
+    * snapshot while other threads are pushing or popping.
+    *
+    * @return the approximate number of values in the queue
+    */
+    size_t sizeApprox() const {
+        size_t t = tail.load(memory_order_acquire);
+        size_t h = head.load(memory_order_acquire);
+        return t > h ? t - h : 0;
+    }
+
+    bool empty() const {
+        return sizeApprox() == 0;
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+};
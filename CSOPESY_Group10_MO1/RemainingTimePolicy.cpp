@@ -0,0 +1,117 @@
+#include <algorithm>
+#include "RemainingTimePolicy.h"
+
+/*
+* This constructor creates an empty shortest-first scheduler
+*
+* @param preemptive - true to preempt at every quantum (srtf), false to run to completion (sjf)
+* @param quantum - the slice length when preemptive
+* @param virtualClock - true if times are virtual ticks
+*/
+RemainingTimePolicy::RemainingTimePolicy(bool preemptive, int quantum, bool virtualClock)
+    : SchedulerPolicy(virtualClock), preemptive(preemptive), quantum(quantum) {}
+
+/*
+* This function adds a process to the heap keyed on its remaining instructions
+*
+* @param process - the process
+* @param now - the current time
+*/
+void RemainingTimePolicy::push(AConsole* process, int64_t now) {
+    process->getSchedulingInfo().readyTime = now;
+    int remaining = process->getInstructionTotal() - process->getInstructionLine();
+    heap.push_back({ remaining, process->getProcessID(), process });
+    push_heap(heap.begin(), heap.end(), Longer());
+    runnableCount.store(heap.size(), memory_order_relaxed);
+}
+
+/*
+* This function admits a new process
+*
+* @param process - the process
+* @param now - the current time
+*/
+void RemainingTimePolicy::admit(AConsole* process, int64_t now) {
+    process->getSchedulingInfo().arrivalTime = now;
+    push(process, now);
+}
+
+/*
+* This function puts a preempted process back with its new remaining count
+*
+* @param process - the process
+* @param executed - the instructions it ran
+* @param slice - the slice it was given
+* @param now - the current time
+*/
+void RemainingTimePolicy::requeue(AConsole* process, [[maybe_unused]] int executed, [[maybe_unused]] int slice, int64_t now) {
+    add(preemptions, 1);
+    push(process, now);
+}
+
+/*
+* This function takes the process with the fewest remaining instructions
+*
+* @param now - the current time
+* @return the process, or nullptr if no process is runnable
+*/
+AConsole* RemainingTimePolicy::pickNext(int64_t now) {
+    if (heap.empty()) return nullptr;
+
+    pop_heap(heap.begin(), heap.end(), Longer());
+    AConsole* process = heap.back().process;
+    heap.pop_back();
+    runnableCount.store(heap.size(), memory_order_relaxed);
+
+    add(waitTotal, now - process->getSchedulingInfo().readyTime);
+    add(dispatches, 1);
+    return process;
+}
+
+/*
+* This function returns the quantum under srtf and no limit under sjf
+*
+* @param process - the process
+* @return the number of instructions it may run
+*/
+int RemainingTimePolicy::timeslice([[maybe_unused]] AConsole* process) {
+    return preemptive ? quantum : 0;
+}
+
+/*
+* This function records the turnaround time of a finished process
+*
+* @param process - the process
+* @param executed - the instructions it ran in its last slice
+* @param now - the current time
+*/
+void RemainingTimePolicy::finished(AConsole* process, [[maybe_unused]] int executed, int64_t now) {
+    int64_t turnaround = now - process->getSchedulingInfo().arrivalTime;
+    add(turnaroundTotal, turnaround);
+    raise(turnaroundMax, turnaround);
+    add(finishedCount, 1);
+}
+
+size_t RemainingTimePolicy::size() const {
+    return heap.size();
+}
+
+/*
+* This function prints the dispatches, preemptions, wait and turnaround times
+*
+* @param out - the stream to print to
+*/
+void RemainingTimePolicy::printStats(ostream& out) const {
+    uint64_t dispatched = dispatches.load(memory_order_relaxed);
+    uint64_t finished = finishedCount.load(memory_order_relaxed);
+
+    out << (preemptive ? "SRTF" : "SJF") << " scheduler: " << runnableCount.load(memory_order_relaxed) << " runnable, "
+        << dispatched << " dispatches, " << preemptions.load(memory_order_relaxed) << " preemptions" << endl;
+    if (dispatched > 0) {
+        out << "Avg wait per dispatch: " << formatTime(waitTotal.load(memory_order_relaxed) / (double)dispatched) << endl;
+    }
+    if (finished > 0) {
+        out << "Avg turnaround: " << formatTime(turnaroundTotal.load(memory_order_relaxed) / (double)finished)
+            << ", max " << formatTime((double)turnaroundMax.load(memory_order_relaxed)) << " over " << finished << " finished" << endl;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "SchedulerPolicy.h"
+
+using namespace std;
+
+/*
+* Shortest job first and shortest remaining time first.
+*
+* Every process knows how many instructions it has left, so the runnable
+* processes are kept in a binary min-heap on that count and the shortest one
+* is always dispatched next. Without preemption (sjf) a process runs to
+* completion once dispatched. With preemption (srtf) it runs one quantum at a
+* time and goes back into the heap, so a shorter arrival takes the core at the
+* next quantum boundary.
+*/
+class RemainingTimePolicy : public SchedulerPolicy {
+private:
+    struct Entry {
+        int remaining;
+        int processID;
+        AConsole* process;
+    };
+
+    // Orders the heap so the fewest remaining instructions are on top, oldest
+    // process first among equals
+    struct Longer {
+        bool operator()(const Entry& a, const Entry& b) const {
+            if (a.remaining != b.remaining) return a.remaining > b.remaining;
+            return a.processID > b.processID;
+        }
+    };
+
+    vector<Entry> heap;
+    bool preemptive;
+    int quantum;
+
+    atomic<size_t> runnableCount{ 0 };
+    atomic<uint64_t> dispatches{ 0 };
+    atomic<uint64_t> preemptions{ 0 };
+    atomic<int64_t> waitTotal{ 0 };
+    atomic<uint64_t> finishedCount{ 0 };
+    atomic<int64_t> turnaroundTotal{ 0 };
+    atomic<int64_t> turnaroundMax{ 0 };
+
+    void push(AConsole* process, int64_t now);
+
+public:
+    RemainingTimePolicy(bool preemptive, int quantum, bool virtualClock);
+
+    void admit(AConsole* process, int64_t now) override;
+    void requeue(AConsole* process, int executed, int slice, int64_t now) override;
+    AConsole* pickNext(int64_t now) override;
+    int timeslice(AConsole* process) override;
+    void finished(AConsole* process, int executed, int64_t now) override;
+    size_t size() const override;
+    void printStats(ostream& out) const override;
+};
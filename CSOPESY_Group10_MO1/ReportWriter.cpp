@@ -0,0 +1,193 @@
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <future>
+#include <filesystem>
+#include <algorithm>
+#include "ReportWriter.h"
+
+mutex ReportWriter::queueMutex;
+condition_variable ReportWriter::queueReady;
+deque<ReportWriter::Job> ReportWriter::jobs;
+bool ReportWriter::writerStarted = false;
+atomic<int> ReportWriter::pendingWrites{ 0 };
+
+// Below this many rows splitting the formatting across threads costs more than it saves
+static const size_t PARALLEL_THRESHOLD = 8192;
+
+/*
+* This function formats rows [begin, end) in the report's tab separated layout
+*
+* @param rows - the rows to format
+* @param begin - the first row to format
+* @param end - one past the last row to format
+* @param finished - true for the finished section, false for the running one
+* @return the formatted lines
+*/
+string ReportWriter::formatChunk(const vector<ReportRow>& rows, size_t begin, size_t end, bool finished) {
+    string out;
+    out.reserve((end - begin) * 64);
+
+    for (size_t i = begin; i < end; ++i) {
+        const ReportRow& row = rows[i];
+        out += row.name();
+        out += '\t';
+        out += row.timestamp();
+        if (finished) {
+            out += "\tFinished\t";
+        }
+        else {
+            out += "\tCore: ";
+            out += to_string(row.state.coreID);
+            out += '\t';
+        }
+        out += to_string(row.state.instructionLine);
+        out += '/';
+        out += to_string(row.state.instructionTotal);
+        out += '\n';
+    }
+    return out;
+}
+
+/*
+* This function formats a whole section, splitting large sections into one
+* chunk per hardware thread
+*
+* @param rows - the rows to format
+* @param finished - true for the finished section, false for the running one
+* @return the formatted lines
+*/
+string ReportWriter::formatRows(const vector<ReportRow>& rows, bool finished) {
+    size_t workers = max(1u, thread::hardware_concurrency());
+    if (rows.size() < PARALLEL_THRESHOLD || workers == 1) {
+        return formatChunk(rows, 0, rows.size(), finished);
+    }
+
+    size_t chunkSize = (rows.size() + workers - 1) / workers;
+    vector<future<string>> chunks;
+    for (size_t begin = 0; begin < rows.size(); begin += chunkSize) {
+        size_t end = min(rows.size(), begin + chunkSize);
+        chunks.push_back(async(launch::async, formatChunk, cref(rows), begin, end, finished));
+    }
+
+    string out;
+    for (auto& chunk : chunks) {
+        out += chunk.get();
+    }
+    return out;
+}
+
+/*
+* This function writes the report to a temporary file and renames it over the
+* target
+*
+* @param fileName - the report file
+* @param report - the full report text
+*/
+void ReportWriter::write(const string& fileName, const string& report) {
+    string tempName = fileName + ".tmp";
+    {
+        ofstream outFile(tempName, ios::out | ios::trunc | ios::binary);
+        if (!outFile.is_open()) {
+            cerr << "Error: unable to open file for writing report details";
+            return;
+        }
+        outFile.write(report.data(), report.size());
+        if (!outFile) {
+            cerr << "Error: unable to write report details";
+            return;
+        }
+    }
+
+    error_code error;
+    filesystem::rename(tempName, fileName, error);
+    if (error) {
+        cerr << "Error: unable to replace " << fileName << ": " << error.message() << "\n";
+        return;
+    }
+    cout << "Report generated: " << fileName << "\n";
+}
+
+/*
+* This function queues a report for the writer thread, starting the thread
+* the first time
+*
+* @param job - the report
+*/
+void ReportWriter::enqueue(Job job) {
+    pendingWrites++;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        jobs.push_back(move(job));
+        if (!writerStarted) {
+            writerStarted = true;
+            thread(writerLoop).detach();
+        }
+    }
+    queueReady.notify_one();
+}
+
+/*
+* This function writes the queued reports one at a time, oldest first
+*/
+void ReportWriter::writerLoop() {
+    while (true) {
+        Job job;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            queueReady.wait(lock, [] { return !jobs.empty(); });
+            job = move(jobs.front());
+            jobs.pop_front();
+        }
+
+        if (job.hasRows) {
+            job.report += "Running Processes:\n";
+            job.report += formatRows(job.running, false);
+            job.report += "\n";
+            if (job.running.empty()) job.report += "No running consoles.\n";
+
+            job.report += "Finished Processes:\n";
+            job.report += formatRows(job.finished, true);
+            job.report += "\n";
+            if (job.finished.empty()) job.report += "No terminated consoles.\n";
+        }
+        write(job.fileName, job.report);
+
+        pendingWrites--;
+        pendingWrites.notify_all();
+    }
+}
+
+/*
+* This function writes an already formatted report on the writer thread
+*
+* @param fileName - the report file
+* @param report - the full report text
+*/
+void ReportWriter::writeAsync(const string& fileName, string report) {
+    enqueue({ fileName, move(report), false, {}, {} });
+}
+
+/*
+* This function formats and writes the report on the writer thread. Reports
+* are written one at a time, in the order they were requested.
+*
+* @param fileName - the report file
+* @param header - the already formatted report header
+* @param running - the running processes
+* @param finished - the finished processes
+*/
+void ReportWriter::writeAsync(const string& fileName, string header, vector<ReportRow> running, vector<ReportRow> finished) {
+    enqueue({ fileName, move(header), true, move(running), move(finished) });
+}
+
+/*
+* This function blocks until every requested report has been written, so the
+* program can exit without losing one
+*/
+void ReportWriter::waitForPending() {
+    int pending;
+    while ((pending = pendingWrites.load()) > 0) {
+        pendingWrites.wait(pending);
+    }
+}
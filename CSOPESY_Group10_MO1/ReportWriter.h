@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "AConsole.h"
+
+using namespace std;
+
+// One process line of the utilization report, copied out of the live tables.
+// The creation time is copied raw, and a name derived from the PID is left
+// empty; both are formatted after the tables are unlocked.
+struct ReportRow {
+    int processID;
+    string storedName;          // empty when the name is derived from the PID
+    time_t createdAt;
+    string restoredTimestamp;   // empty unless the console was restored
+    AConsole::Snapshot state;
+
+    string name() const {
+        return storedName.empty() ? AConsole::nameForPid(processID) : storedName;
+    }
+
+    string timestamp() const {
+        return restoredTimestamp.empty() ? AConsole::formatTime(createdAt) : restoredTimestamp;
+    }
+};
+
+/*
+* Formats and writes the utilization report off the caller's thread.
+*
+* The caller hands over a snapshot of the rows and returns immediately. One
+* writer thread takes the requests from a FIFO queue, so reports are written
+* in the order they were requested and a newer report is never overwritten
+* by an older one. The writer formats the rows, in parallel chunks when there
+* are many, writes the whole report to a temporary file in one buffered
+* write, and then renames it over the target so a half-written report is
+* never visible.
+*/
+class ReportWriter {
+private:
+    // A requested report; rows are formatted by the writer unless the report
+    // is already complete
+    struct Job {
+        string fileName;
+        string report;
+        bool hasRows;
+        vector<ReportRow> running;
+        vector<ReportRow> finished;
+    };
+
+    static mutex queueMutex;
+    static condition_variable queueReady;
+    static deque<Job> jobs;
+    static bool writerStarted;
+    static atomic<int> pendingWrites;
+
+    static void enqueue(Job job);
+    static void writerLoop();
+    static string formatRows(const vector<ReportRow>& rows, bool finished);
+    static string formatChunk(const vector<ReportRow>& rows, size_t begin, size_t end, bool finished);
+    static void write(const string& fileName, const string& report);
+
+public:
+    static void writeAsync(const string& fileName, string report);
+    static void writeAsync(const string& fileName, string header, vector<ReportRow> running, vector<ReportRow> finished);
+    static void waitForPending();
+};
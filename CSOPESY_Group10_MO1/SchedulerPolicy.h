@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include "AConsole.h"
+
+using namespace std;
+
+/*
+* The ready-queue ordering of a queue-based scheduler.
+*
+* FCFS and RR keep their own queues. Every other scheduler plugs a policy
+* into the same dispatch path: the dispatcher admits arrivals, asks the policy
+* which process to run next and for how long, and hands the process back after
+* each slice. The policy is only called with processMutex held, except for
+* printStats: statistics are kept in relaxed atomics so reports can print
+* them without the lock, a few events behind at worst.
+*
+* Times are nanoseconds since the scheduler started in real-time mode and
+* ticks in virtual-clock mode.
+*/
+class SchedulerPolicy {
+protected:
+    bool virtualClock;
+
+    /*
+    * This function adds to a statistic. Only the scheduler, holding
+    * processMutex, writes statistics, so a plain load and store is enough.
+    *
+    * @param statistic - the statistic
+    * @param amount - the amount to add
+    */
+    template <typename T, typename U>
+    static void add(atomic<T>& statistic, U amount) {
+        statistic.store(statistic.load(memory_order_relaxed) + (T)amount, memory_order_relaxed);
+    }
+
+    /*
+    * This function raises a statistic to a new maximum
+    *
+    * @param statistic - the statistic
+    * @param value - the value it must be at least
+    */
+    template <typename T, typename U>
+    static void raise(atomic<T>& statistic, U value) {
+        if ((T)value > statistic.load(memory_order_relaxed)) {
+            statistic.store((T)value, memory_order_relaxed);
+        }
+    }
+
+    /*
+    * This function formats a duration in the scheduler's time unit
+    *
+    * @param duration - nanoseconds or ticks
+    * @return the duration in ms or ticks
+    */
+    string formatTime(double duration) const {
+        ostringstream text;
+        if (virtualClock) {
+            text << fixed << setprecision(1) << duration << " ticks";
+        }
+        else {
+            text << fixed << setprecision(3) << duration / 1e6 << " ms";
+        }
+        return text.str();
+    }
+
+public:
+    explicit SchedulerPolicy(bool virtualClock) : virtualClock(virtualClock) {}
+    virtual ~SchedulerPolicy() = default;
+
+    // A process became runnable for the first time
+    virtual void admit(AConsole* process, int64_t now) = 0;
+
+    // A process ran executed instructions of a slice and is runnable again
+    virtual void requeue(AConsole* process, int executed, int slice, int64_t now) = 0;
+
+    // The runnable process to dispatch next, or nullptr if there is none
+    virtual AConsole* pickNext(int64_t now) = 0;
+
+    // The number of instructions the process may run, 0 for no limit
+    virtual int timeslice(AConsole* process) = 0;
+
+    // A process ran executed instructions of its last slice and finished
+    virtual void finished(AConsole* process, int executed, int64_t now) = 0;
+
+    virtual size_t size() const = 0;
+    virtual void printStats(ostream& out) const = 0;
+};
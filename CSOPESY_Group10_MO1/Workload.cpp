@@ -0,0 +1,287 @@
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <algorithm>
+#include <iostream>
+#include "Workload.h"
+
+// The calling thread's generator and the workload configuration it was
+// seeded from
+struct ThreadRandom {
+    const Workload* owner = nullptr;
+    uint64_t generation = 0;
+    FastRandom random;
+};
+
+static thread_local ThreadRandom threadRandom;
+static atomic<uint64_t> nextGeneration{ 1 };
+
+/*
+* This function sets the seed and the arrival source. A seed of 0 picks a
+* random one, which printStats reports so the run can be repeated. Replaying
+* a trace adopts the seed it was recorded with.
+*
+* @param seed - the workload seed, 0 for a random one
+* @param mode - generate, record or replay
+* @param traceFile - the trace to write or read
+* @param minIns - the fewest instructions a generated process has
+* @param maxIns - the most instructions a generated process has
+* @return true if the trace could be opened, false if the workload fell back to generating
+*/
+bool Workload::configure(uint64_t seed, Mode mode, const string& traceFile, int minIns, int maxIns) {
+    lock_guard<mutex> lock(traceMutex);
+
+    if (seed == 0) {
+        random_device device;
+        seed = ((uint64_t)device() << 32) | device();
+    }
+    this->seed = seed;
+    this->mode = mode;
+    this->traceFile = traceFile;
+    this->minIns = minIns;
+    this->maxIns = maxIns;
+    generation = nextGeneration++;
+    nextStream = FIRST_SHARED_STREAM;
+
+    traceOut.close();
+    replay.clear();
+    recorded = 0;
+    firstArrivalNs = 0;
+    lastRecordedNs = 0;
+
+    string error;
+    bool opened = true;
+    if (mode == RECORD) opened = openRecording(error);
+    else if (mode == REPLAY) opened = loadReplay(error);
+
+    if (!opened) {
+        cerr << "Error: Could not use workload trace " << traceFile << ": " << error << ". Generating the workload instead.\n";
+        this->mode = GENERATE;
+    }
+    return opened;
+}
+
+/*
+* This function creates the trace file and writes its header
+*
+* @param error - receives a description of the problem
+* @return true if the trace is ready for records, false otherwise
+*/
+bool Workload::openRecording(string& error) {
+    traceOut.open(traceFile, ios::out | ios::trunc | ios::binary);
+    if (!traceOut.is_open()) {
+        error = "could not create file";
+        return false;
+    }
+
+    TraceHeader header = {};
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.headerSize = sizeof(TraceHeader);
+    header.seed = seed;
+    header.minIns = minIns;
+    header.maxIns = maxIns;
+    traceOut.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    traceOut.flush();
+    if (!traceOut) {
+        error = "could not write header";
+        return false;
+    }
+    return true;
+}
+
+/*
+* This function reads every record of the trace and validates the header
+*
+* @param error - receives a description of the problem
+* @return true if the trace can be replayed, false otherwise
+*/
+bool Workload::loadReplay(string& error) {
+    ifstream traceIn(traceFile, ios::in | ios::binary);
+    if (!traceIn.is_open()) {
+        error = "could not open file";
+        return false;
+    }
+
+    TraceHeader header;
+    if (!traceIn.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        error = "file is too small";
+        return false;
+    }
+    if (memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0) {
+        error = "not a workload trace";
+        return false;
+    }
+    if (header.version != TRACE_VERSION || header.headerSize != sizeof(TraceHeader)) {
+        error = "unsupported trace version " + to_string(header.version);
+        return false;
+    }
+
+    error_code sizeError;
+    uintmax_t fileSize = filesystem::file_size(traceFile, sizeError);
+    if (sizeError) {
+        error = "could not read file size";
+        return false;
+    }
+    // A trace cut off mid-record keeps its complete records
+    size_t count = (size_t)((fileSize - sizeof(TraceHeader)) / sizeof(TraceRecord));
+    replay.resize(count);
+    if (!traceIn.read(reinterpret_cast<char*>(replay.data()), count * sizeof(TraceRecord))) {
+        error = "could not read records";
+        replay.clear();
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (replay[i].instructions < 1 || replay[i].arrivalNs < 0 || (i > 0 && replay[i].arrivalNs < replay[i - 1].arrivalNs)) {
+            error = "record " + to_string(i) + " is invalid";
+            replay.clear();
+            return false;
+        }
+    }
+
+    seed = header.seed;
+    return true;
+}
+
+/*
+* This function returns the calling thread's generator, seeding it from the
+* workload seed and the next free stream the first time the thread asks
+*
+* @return the generator
+*/
+FastRandom& Workload::random() {
+    if (threadRandom.owner != this || threadRandom.generation != generation) {
+        threadRandom = { this, generation, FastRandom(FastRandom::mix(seed ^ FastRandom::mix(nextStream++))) };
+    }
+    return threadRandom.random;
+}
+
+/*
+* This function seeds the calling thread's generator from a fixed stream, so
+* the thread draws the same values in every run with the same seed no matter
+* which other threads asked for a generator first
+*
+* @param stream - the stream, below FIRST_SHARED_STREAM
+*/
+void Workload::seedThread(uint64_t stream) {
+    threadRandom = { this, generation, FastRandom(FastRandom::mix(seed ^ FastRandom::mix(stream))) };
+}
+
+/*
+* This function generates the next arrival and records it when recording
+*
+* @return the arrival, timed now
+*/
+Workload::Arrival Workload::next() {
+    FastRandom& generator = random();
+    Arrival arrival = { nowNs(), generator.between(minIns, maxIns), generator.next() };
+    if (mode == RECORD) {
+        record(&arrival, 1);
+    }
+    return arrival;
+}
+
+/*
+* This function generates a batch of arrivals that arrive together and
+* records them with a single write when recording
+*
+* @param arrivals - receives the arrivals
+* @param count - the number of arrivals
+*/
+void Workload::nextBatch(Arrival* arrivals, size_t count) {
+    FastRandom& generator = random();
+    int64_t now = nowNs();
+    for (size_t i = 0; i < count; ++i) {
+        arrivals[i] = { now, generator.between(minIns, maxIns), generator.next() };
+    }
+    if (mode == RECORD) {
+        record(arrivals, count);
+    }
+}
+
+/*
+* This function appends arrivals to the trace. Times are stored relative to
+* the first recorded arrival, so a replay starts right away, and never go
+* backwards when two threads race to record.
+*
+* @param arrivals - the arrivals, timed in steady-clock nanoseconds
+* @param count - the number of arrivals
+*/
+void Workload::record(const Arrival* arrivals, size_t count) {
+    lock_guard<mutex> lock(traceMutex);
+    if (mode != RECORD || count == 0) return;
+
+    if (recorded == 0) {
+        firstArrivalNs = arrivals[0].arrivalNs;
+    }
+    vector<TraceRecord> records(count);
+    for (size_t i = 0; i < count; ++i) {
+        lastRecordedNs = max(lastRecordedNs, arrivals[i].arrivalNs - firstArrivalNs);
+        records[i] = { lastRecordedNs, arrivals[i].delaySeed, arrivals[i].instructions, 0 };
+    }
+
+    // Flushed per call: the program leaves with quick_exit, which skips the
+    // stream's destructor
+    traceOut.write(reinterpret_cast<const char*>(records.data()), count * sizeof(TraceRecord));
+    traceOut.flush();
+    recorded += count;
+}
+
+Workload::Mode Workload::getMode() const {
+    return mode;
+}
+
+uint64_t Workload::getSeed() const {
+    return seed;
+}
+
+size_t Workload::replayLength() const {
+    return replay.size();
+}
+
+/*
+* This function returns an arrival of the replayed trace
+*
+* @param index - the arrival, in trace order
+* @return the arrival, timed from the start of the replay
+*/
+Workload::Arrival Workload::replayed(size_t index) const {
+    const TraceRecord& record = replay[index];
+    return { record.arrivalNs, record.instructions, record.delaySeed };
+}
+
+/*
+* This function prints the seed and what the trace is doing
+*
+* @param out - the stream to print to
+*/
+void Workload::printStats(ostream& out) {
+    lock_guard<mutex> lock(traceMutex);
+    out << "Workload seed: " << seed;
+    if (mode == RECORD) {
+        out << ", recorded " << recorded << " arrivals to " << traceFile;
+    }
+    else if (mode == REPLAY) {
+        out << ", replaying " << replay.size() << " arrivals from " << traceFile;
+    }
+    out << endl;
+}
+
+/*
+* This function returns the pause before an instruction, 10 to 20 ms. The
+* value depends only on the process's delay seed and the instruction, so a
+* replayed process pauses exactly as it did when it was recorded.
+*
+* @param delaySeed - the process's delay seed
+* @param instructionLine - the instruction about to run
+* @return the delay in milliseconds
+*/
+int Workload::instructionDelay(uint64_t delaySeed, int instructionLine) {
+    FastRandom generator(delaySeed + (uint64_t)instructionLine * FastRandom::GAMMA);
+    return generator.between(10, 20);
+}
+
+int64_t Workload::nowNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
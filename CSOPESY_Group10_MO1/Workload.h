@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <atomic>
+#include <ostream>
+#include "FastRandom.h"
+
+using namespace std;
+
+/*
+* On-disk layout of a workload trace.
+*
+*   TraceHeader
+*   TraceRecord[]   (to the end of the file)
+*
+* One fixed-width record per arrival, appended as processes arrive, so a run
+* that is cut short still leaves a readable trace. Per-instruction delays are
+* not stored one by one: each process draws them, and its program body, from
+* its own splitmix stream, and the record keeps that stream's seed.
+*/
+const char TRACE_MAGIC[8] = { 'C', 'S', 'O', 'P', 'T', 'R', 'C', 'E' };
+const uint32_t TRACE_VERSION = 1;
+
+struct TraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t seed;
+    int32_t minIns;
+    int32_t maxIns;
+};
+
+struct TraceRecord {
+    int64_t arrivalNs;      // since the first recorded arrival
+    uint64_t delaySeed;
+    int32_t instructions;
+    int32_t reserved;
+};
+
+/*
+* The source of process arrivals.
+*
+* GENERATE draws instruction counts and delay seeds from the calling thread's
+* generator. Every thread's generator is derived from one seed, so a run with
+* a fixed seed creates the same processes again. RECORD also appends every
+* arrival to a trace, and REPLAY reads the arrivals of a trace back with
+* their original spacing.
+*/
+class Workload {
+public:
+    enum Mode { GENERATE, RECORD, REPLAY };
+
+    struct Arrival {
+        int64_t arrivalNs;
+        int instructions;
+        uint64_t delaySeed;
+    };
+
+    // Streams below this are handed out explicitly with seedThread
+    static constexpr uint64_t FIRST_SHARED_STREAM = 1ull << 32;
+
+private:
+    Mode mode = GENERATE;
+    uint64_t seed = 0;
+    int minIns = 1;
+    int maxIns = 1;
+    uint64_t generation = 0;
+    atomic<uint64_t> nextStream{ FIRST_SHARED_STREAM };
+
+    mutex traceMutex;
+    string traceFile;
+    ofstream traceOut;
+    int64_t firstArrivalNs = 0;
+    int64_t lastRecordedNs = 0;
+    uint64_t recorded = 0;
+    vector<TraceRecord> replay;
+
+    bool openRecording(string& error);
+    bool loadReplay(string& error);
+
+public:
+    bool configure(uint64_t seed, Mode mode, const string& traceFile, int minIns, int maxIns);
+    FastRandom& random();
+    void seedThread(uint64_t stream);
+    Arrival next();
+    void nextBatch(Arrival* arrivals, size_t count);
+    void record(const Arrival* arrivals, size_t count);
+    Mode getMode() const;
+    uint64_t getSeed() const;
+    size_t replayLength() const;
+    Arrival replayed(size_t index) const;
+    void printStats(ostream& out);
+
+    static int instructionDelay(uint64_t delaySeed, int instructionLine);
+    static int64_t nowNs();
+};
@@ -0,0 +1,89 @@
+/*
+* Throughput benchmark for the process bytecode interpreter.
+*
+* A batch of programs is generated the same way the emulator does and then
+* run to completion twice: once through Program::run with a large budget (the
+* raw dispatch loop) and once one instruction at a time through
+* AConsole::executeInstruction, which is what every virtual-time tick does.
+* Both report simulated instructions per second on one host core.
+*
+* Build: the interpreter_benchmark target of CMakeLists.txt in the parent
+* directory.
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include "../Program.h"
+#include "../AConsole.h"
+
+using namespace std;
+
+const int PROGRAM_COUNT = 64;
+const int INSTRUCTIONS_PER_PROGRAM = 1000000;
+
+/*
+* This function runs every program to completion through the interpreter
+*
+* @param programs - the compiled programs
+* @return the number of instructions executed per second
+*/
+double benchmarkInterpreter(const vector<Program>& programs) {
+    uint64_t executed = 0;
+    auto start = chrono::steady_clock::now();
+
+    for (const Program& program : programs) {
+        Program::State state;
+        uint64_t ran;
+        while ((ran = program.run(state, INSTRUCTIONS_PER_PROGRAM)) > 0) {
+            executed += ran;
+        }
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return executed / seconds;
+}
+
+/*
+* This function runs every process to completion one instruction per step,
+* the way the virtual clock drives a core
+*
+* @return the number of instructions executed per second
+*/
+double benchmarkConsoleSteps() {
+    vector<unique_ptr<AConsole>> consoles;
+    for (int i = 0; i < PROGRAM_COUNT; ++i) {
+        consoles.push_back(make_unique<AConsole>(i + 1, "process" + to_string(i), INSTRUCTIONS_PER_PROGRAM));
+        consoles.back()->dispatch(0);
+    }
+
+    uint64_t executed = 0;
+    auto start = chrono::steady_clock::now();
+
+    for (auto& console : consoles) {
+        bool hasMore = true;
+        while (hasMore) {
+            hasMore = console->executeInstruction();
+            executed++;
+        }
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return executed / seconds;
+}
+
+int main() {
+    vector<Program> programs;
+    size_t codeSize = 0;
+    for (int i = 0; i < PROGRAM_COUNT; ++i) {
+        programs.push_back(Program::generate(INSTRUCTIONS_PER_PROGRAM, i + 1));
+        codeSize += programs.back().size();
+    }
+
+    cout << PROGRAM_COUNT << " programs x " << INSTRUCTIONS_PER_PROGRAM << " instructions, "
+         << fixed << setprecision(1) << (double)codeSize / PROGRAM_COUNT << " bytecode instructions each\n";
+    cout << "interpreter:    " << setprecision(2) << benchmarkInterpreter(programs) / 1e6 << " M instructions/sec\n";
+    cout << "per-tick steps: " << setprecision(2) << benchmarkConsoleSteps() / 1e6 << " M instructions/sec\n";
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*
+* Contention microbenchmark for the waiting queue.
+*
+* Every thread plays the part of a core: it repeatedly dequeues a process and
+* requeues it, which is the RR hot path. The lock-free ReadyQueue is compared
+* against the queue<AConsole*> + mutex pair it replaced, for 1 to 128 threads.
+*
+* Build (from this directory):
+*   g++ -std=c++20 -O2 -pthread ReadyQueueBenchmark.cpp -o ready_queue_bench
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include "../ReadyQueue.h"
+
+using namespace std;
+
+const int OPS_PER_THREAD = 200000;
+const int PRELOADED_ITEMS = 1024;
+
+class LockedQueue {
+private:
+    queue<int> items;
+    mutex itemsMutex;
+
+public:
+    bool tryPush(int value) {
+        lock_guard<mutex> lock(itemsMutex);
+        items.push(value);
+        return true;
+    }
+
+    bool tryPop(int& value) {
+        lock_guard<mutex> lock(itemsMutex);
+        if (items.empty()) return false;
+        value = items.front();
+        items.pop();
+        return true;
+    }
+};
+
+/*
+* This function runs the dequeue/requeue loop on the given number of threads
+*
+* @return the number of queue operations per second
+*/
+template <typename Queue>
+double runBenchmark(Queue& queue, int threadCount) {
+    for (int i = 0; i < PRELOADED_ITEMS; ++i) {
+        queue.tryPush(i);
+    }
+
+    atomic<bool> start{ false };
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&queue, &start] {
+            while (!start) this_thread::yield();
+            int value;
+            for (int op = 0; op < OPS_PER_THREAD; ++op) {
+                if (queue.tryPop(value)) {
+                    queue.tryPush(value);
+                }
+            }
+        });
+    }
+
+    auto begin = chrono::steady_clock::now();
+    start = true;
+    for (auto& t : threads) t.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    return 2.0 * OPS_PER_THREAD * threadCount / seconds;
+}
+
+int main() {
+    cout << setw(8) << "threads" << setw(18) << "mutex ops/sec" << setw(18) << "lock-free ops/sec" << setw(10) << "speedup" << endl;
+
+    for (int threadCount = 1; threadCount <= 128; threadCount *= 2) {
+        LockedQueue locked;
+        ReadyQueue<int> lockFree(PRELOADED_ITEMS * 2);
+
+        double lockedRate = runBenchmark(locked, threadCount);
+        double lockFreeRate = runBenchmark(lockFree, threadCount);
+
+        cout << setw(8) << threadCount
+            << setw(18) << fixed << setprecision(0) << lockedRate
+            << setw(18) << lockFreeRate
+            << setw(9) << setprecision(2) << lockFreeRate / lockedRate << "x" << endl;
+    }
+
+    return 0;
+}
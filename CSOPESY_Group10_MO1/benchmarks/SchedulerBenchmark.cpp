@@ -0,0 +1,282 @@
+/*
+* Headless throughput and latency benchmark for the scheduler.
+*
+* Runs the real ConsoleManager, cores and scheduler without the command-line
+* menu: it writes a configuration for the requested workload, submits the
+* processes at the requested arrival rate, waits for all of them to finish
+* and prints one machine-readable record with throughput, latency percentiles
+* and CPU utilization. Compare records across commits to catch regressions.
+*
+* Real-clock mode sleeps 10-20 ms per instruction to pace the emulator, so it
+* measures the emulator at human speed. Virtual-clock mode runs ticks back to
+* back and measures the scheduler itself; it is the default.
+*
+* Build: the scheduler_benchmark target of CMakeLists.txt in the parent
+* directory.
+*
+* Usage: scheduler_benchmark [--cores N] [--scheduler NAME] [--quantum N]
+*            [--min-ins N] [--max-ins N] [--processes N] [--arrival-rate N]
+*            [--clock real|virtual] [--delay N] [--max-finished N]
+*            [--timeout SECONDS] [--format json|csv] [--seed N]
+*            [--record FILE | --replay FILE] [--batch N]
+*
+* --arrival-rate is processes per second; 0 submits every process at once.
+* --seed fixes the instruction counts and delays, so two builds can be timed
+* on identical input. --record also saves the arrivals to a trace, and
+* --replay runs a saved trace with its recorded spacing instead of --processes
+* and --arrival-rate. --batch admits N processes at a time through the bulk
+* path scheduler-test uses, each batch at the arrival time of its first
+* process; admissions_per_sec times the admission calls alone.
+*/
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <thread>
+#include <filesystem>
+#include <cstdlib>
+#include "../ConsoleManager.h"
+
+using namespace std;
+
+struct WorkloadOptions {
+    int cores = 4;
+    string scheduler = "rr";
+    int quantum = 5;
+    int minIns = 100;
+    int maxIns = 1000;
+    int processes = 1000;
+    double arrivalRate = 0;
+    string clock = "virtual";
+    int delay = 0;
+    int maxFinished = 0;
+    int timeoutSeconds = 600;
+    string format = "json";
+    uint64_t seed = 0;
+    string trace = "off";
+    string traceFile;
+    int batch = 0;
+};
+
+ConsoleManager consoles;
+
+/*
+* This function reads the workload from the command line
+*
+* @param argc - the argument count
+* @param argv - the arguments
+* @param workload - receives the workload
+* @return true if every argument was understood, false otherwise
+*/
+bool parseArguments(int argc, char* argv[], WorkloadOptions& workload) {
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Error: Missing value for " << option << endl;
+            return false;
+        }
+        istringstream value(argv[++i]);
+
+        bool parsed;
+        if (option == "--cores") parsed = (bool)(value >> workload.cores) && workload.cores > 0;
+        else if (option == "--scheduler") parsed = (bool)(value >> workload.scheduler);
+        else if (option == "--quantum") parsed = (bool)(value >> workload.quantum) && workload.quantum > 0;
+        else if (option == "--min-ins") parsed = (bool)(value >> workload.minIns) && workload.minIns > 0;
+        else if (option == "--max-ins") parsed = (bool)(value >> workload.maxIns) && workload.maxIns > 0;
+        else if (option == "--processes") parsed = (bool)(value >> workload.processes) && workload.processes > 0;
+        else if (option == "--arrival-rate") parsed = (bool)(value >> workload.arrivalRate) && workload.arrivalRate >= 0;
+        else if (option == "--clock") parsed = (bool)(value >> workload.clock) && (workload.clock == "real" || workload.clock == "virtual");
+        else if (option == "--delay") parsed = (bool)(value >> workload.delay) && workload.delay >= 0;
+        else if (option == "--max-finished") parsed = (bool)(value >> workload.maxFinished) && workload.maxFinished >= 0;
+        else if (option == "--timeout") parsed = (bool)(value >> workload.timeoutSeconds) && workload.timeoutSeconds > 0;
+        else if (option == "--format") parsed = (bool)(value >> workload.format) && (workload.format == "json" || workload.format == "csv");
+        else if (option == "--seed") parsed = (bool)(value >> workload.seed);
+        else if (option == "--batch") parsed = (bool)(value >> workload.batch) && workload.batch > 0;
+        else if (option == "--record" || option == "--replay") {
+            workload.trace = option.substr(2);
+            parsed = (bool)(value >> workload.traceFile);
+        }
+        else {
+            cerr << "Error: Unknown option " << option << endl;
+            return false;
+        }
+
+        if (!parsed) {
+            cerr << "Error: Invalid value for " << option << ": " << argv[i] << endl;
+            return false;
+        }
+    }
+    if (workload.minIns > workload.maxIns) {
+        cerr << "Error: --min-ins must not be greater than --max-ins" << endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+* This function writes the configuration file the emulator reads
+*
+* @param workload - the workload
+* @param fileName - the file to write
+*/
+void writeConfig(const WorkloadOptions& workload, const string& fileName) {
+    ofstream config(fileName);
+    config << "num-cpu " << workload.cores << "\n"
+           << "scheduler \"" << workload.scheduler << "\"\n"
+           << "quantum-cycles " << workload.quantum << "\n"
+           << "batch-process-freq 1\n"
+           << "min-ins " << workload.minIns << "\n"
+           << "max-ins " << workload.maxIns << "\n"
+           << "delays-per-exec " << workload.delay << "\n"
+           << "clock-mode \"" << workload.clock << "\"\n"
+           << "max-finished " << workload.maxFinished << "\n"
+           << "seed " << workload.seed << "\n"
+           << "workload-trace \"" << workload.trace << "\"\n";
+    if (workload.trace != "off") {
+        config << "trace-file " << quoted(workload.traceFile) << "\n";
+    }
+}
+
+/*
+* This function adds the percentiles of one histogram to the results
+*
+* @param results - the results
+* @param name - the latency name
+* @param histogram - the histogram
+*/
+void addLatency(vector<pair<string, string>>& results, const string& name, const LatencyHistogram& histogram) {
+    results.emplace_back(name + "_count", to_string(histogram.count()));
+    results.emplace_back(name + "_p50_ns", to_string(histogram.percentile(0.5)));
+    results.emplace_back(name + "_p90_ns", to_string(histogram.percentile(0.9)));
+    results.emplace_back(name + "_p99_ns", to_string(histogram.percentile(0.99)));
+    results.emplace_back(name + "_p999_ns", to_string(histogram.percentile(0.999)));
+    results.emplace_back(name + "_max_ns", to_string(histogram.max()));
+}
+
+/*
+* This function formats a number for the results
+*
+* @param value - the number
+* @return the number with up to six decimals
+*/
+string number(double value) {
+    ostringstream text;
+    text << fixed << setprecision(6) << value;
+    return text.str();
+}
+
+int main(int argc, char* argv[]) {
+    WorkloadOptions workload;
+    if (!parseArguments(argc, argv, workload)) {
+        return 2;
+    }
+
+    string configFile = (filesystem::temp_directory_path() / ("scheduler-benchmark-" + to_string(chrono::steady_clock::now().time_since_epoch().count()) + ".txt")).string();
+    writeConfig(workload, configFile);
+    consoles.initialize(configFile);
+    filesystem::remove(configFile);
+
+    if (workload.trace == "replay") {
+        if (consoles.getWorkload().getMode() != Workload::REPLAY) {
+            return 1;
+        }
+        workload.processes = (int)consoles.getWorkload().replayLength();
+    }
+
+    // Submit at absolute deadlines so a slow addConsole does not lower the rate
+    auto start = chrono::steady_clock::now();
+    chrono::steady_clock::duration admissionTime{};
+    if (workload.trace == "replay") {
+        consoles.schedulerTest(true);
+    }
+    int submitted = 0;
+    while (submitted < workload.processes && workload.trace != "replay") {
+        if (workload.arrivalRate > 0) {
+            this_thread::sleep_until(start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(submitted / workload.arrivalRate)));
+        }
+
+        auto admissionStart = chrono::steady_clock::now();
+        if (workload.batch > 0) {
+            size_t added = consoles.addConsoles(min(workload.batch, workload.processes - submitted));
+            admissionTime += chrono::steady_clock::now() - admissionStart;
+            submitted += (int)added;
+            if (added == 0) {
+                // The waiting queue is full until the cores catch up
+                this_thread::yield();
+            }
+        }
+        else {
+            consoles.addConsole("process" + to_string(submitted + 1), false);
+            admissionTime += chrono::steady_clock::now() - admissionStart;
+            submitted++;
+        }
+    }
+    double admissionSeconds = chrono::duration<double>(admissionTime).count();
+
+    auto deadline = start + chrono::seconds(workload.timeoutSeconds);
+    bool timedOut = false;
+    while (consoles.getMetrics().finished < (uint64_t)workload.processes) {
+        if (chrono::steady_clock::now() > deadline) {
+            timedOut = true;
+            break;
+        }
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    ConsoleManager::Metrics metrics = consoles.getMetrics();
+
+    vector<pair<string, string>> results = {
+        { "scheduler", "\"" + workload.scheduler + "\"" },
+        { "clock", "\"" + workload.clock + "\"" },
+        { "cores", to_string(workload.cores) },
+        { "quantum", to_string(workload.quantum) },
+        { "min_ins", to_string(workload.minIns) },
+        { "max_ins", to_string(workload.maxIns) },
+        { "processes", to_string(workload.processes) },
+        { "arrival_rate", number(workload.arrivalRate) },
+        { "seed", to_string(consoles.getWorkload().getSeed()) },
+        { "completed", timedOut ? "false" : "true" },
+        { "finished", to_string(metrics.finished) },
+        { "elapsed_s", number(elapsed) },
+        { "processes_per_sec", number(metrics.finished / elapsed) },
+        { "admissions_per_sec", number(admissionSeconds > 0 ? submitted / admissionSeconds : 0) },
+        { "instructions", to_string(metrics.instructions) },
+        { "instructions_per_sec", number(metrics.instructions / elapsed) },
+        { "dispatches", to_string(metrics.dispatches) },
+        { "migrations", to_string(metrics.migrations) },
+        { "cpu_utilization", number(metrics.utilization) },
+    };
+    if (metrics.latencies != nullptr) {
+        addLatency(results, "wait", metrics.latencies->wait);
+        addLatency(results, "requeue_wait", metrics.latencies->requeueWait);
+        addLatency(results, "response", metrics.latencies->response);
+        addLatency(results, "turnaround", metrics.latencies->turnaround);
+    }
+
+    if (workload.format == "json") {
+        cout << "{";
+        for (size_t i = 0; i < results.size(); ++i) {
+            cout << (i > 0 ? ", " : "") << "\"" << results[i].first << "\": " << results[i].second;
+        }
+        cout << "}" << endl;
+    }
+    else {
+        for (size_t i = 0; i < results.size(); ++i) {
+            cout << (i > 0 ? "," : "") << results[i].first;
+        }
+        cout << "\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            string value = results[i].second;
+            if (!value.empty() && value.front() == '"') value = value.substr(1, value.size() - 2);
+            cout << (i > 0 ? "," : "") << value;
+        }
+        cout << endl;
+    }
+
+    // The core and scheduler threads are detached and never return
+    quick_exit(timedOut ? 1 : 0);
+}
@@ -0,0 +1,225 @@
+/*
+* Side-by-side comparison of the schedulers on one generated workload.
+*
+* A seeded mix of short and long processes arrives as a Poisson stream and is run
+* to completion under fcfs, rr, sjf, srtf, mlfq and fair. The cores advance in
+* lockstep one instruction per tick, the same model as the virtual clock, so
+* every scheduler sees exactly the same arrivals and service demands and the
+* only difference is the order in which the policy dispatches processes. SLEEP
+* stalls are left out for the same reason.
+*
+* fcfs and rr keep their own queues in the emulator; here they are small FIFO
+* policies so all six go through the same SchedulerPolicy calls.
+*
+* Build: the scheduler_comparison target of CMakeLists.txt in the parent
+* directory.
+*
+* Usage: scheduler_comparison [cores] [processes] [seed]
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <algorithm>
+#include "../AConsole.h"
+#include "../MlfqPolicy.h"
+#include "../FairPolicy.h"
+#include "../RemainingTimePolicy.h"
+
+using namespace std;
+
+const int QUANTUM = 5;
+const double SHORT_FRACTION = 0.8;
+const int SHORT_JOB_MIN = 10;
+const int SHORT_JOB_MAX = 100;
+const int LONG_JOB_MIN = 1000;
+const int LONG_JOB_MAX = 5000;
+const double TARGET_LOAD = 0.9;
+
+/*
+* First-come first-served, or round robin when given a quantum
+*/
+class FifoPolicy : public SchedulerPolicy {
+private:
+    deque<AConsole*> queue;
+    int quantum;
+
+public:
+    explicit FifoPolicy(int quantum) : SchedulerPolicy(true), quantum(quantum) {}
+
+    void admit(AConsole* process, int64_t) override { queue.push_back(process); }
+    void requeue(AConsole* process, int, int, int64_t) override { queue.push_back(process); }
+    AConsole* pickNext(int64_t) override {
+        if (queue.empty()) return nullptr;
+        AConsole* process = queue.front();
+        queue.pop_front();
+        return process;
+    }
+    int timeslice(AConsole*) override { return quantum; }
+    void finished(AConsole*, int, int64_t) override {}
+    size_t size() const override { return queue.size(); }
+    void printStats(ostream&) const override {}
+};
+
+struct Job {
+    int64_t arrival;
+    int instructions;
+    bool isShort;
+};
+
+struct Result {
+    double meanTurnaround;
+    double meanWait;
+    double meanShortTurnaround;
+    double meanLongTurnaround;
+    int64_t maxTurnaround;
+    int64_t makespan;
+    uint64_t dispatches;
+};
+
+/*
+* This function generates the arrivals, spacing them so the cores stay at
+* the target load on average
+*
+* @param count - the number of processes
+* @param cores - the number of cores
+* @param seed - the workload seed
+* @return the jobs in arrival order
+*/
+vector<Job> generateWorkload(int count, int cores, uint64_t seed) {
+    mt19937_64 random(seed);
+    bernoulli_distribution isShort(SHORT_FRACTION);
+    uniform_int_distribution<int> shortLength(SHORT_JOB_MIN, SHORT_JOB_MAX);
+    uniform_int_distribution<int> longLength(LONG_JOB_MIN, LONG_JOB_MAX);
+
+    double meanLength = SHORT_FRACTION * (SHORT_JOB_MIN + SHORT_JOB_MAX) / 2.0 + (1 - SHORT_FRACTION) * (LONG_JOB_MIN + LONG_JOB_MAX) / 2.0;
+    exponential_distribution<double> gap(cores * TARGET_LOAD / meanLength);
+
+    vector<Job> jobs;
+    double time = 0;
+    for (int i = 0; i < count; ++i) {
+        bool shortJob = isShort(random);
+        jobs.push_back({ (int64_t)time, shortJob ? shortLength(random) : longLength(random), shortJob });
+        time += gap(random);
+    }
+    return jobs;
+}
+
+/*
+* This function runs the workload to completion under a policy
+*
+* @param jobs - the workload
+* @param cores - the number of cores
+* @param policy - the scheduling policy
+* @return the turnaround statistics
+*/
+Result simulate(const vector<Job>& jobs, int cores, SchedulerPolicy& policy) {
+    struct Core {
+        AConsole* process = nullptr;
+        size_t job = 0;
+        int executed = 0;
+        int slice = 0;
+    };
+
+    vector<unique_ptr<AConsole>> consoles;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        consoles.push_back(make_unique<AConsole>((int)i + 1, "process" + to_string(i), jobs[i].instructions));
+    }
+
+    vector<Core> running(cores);
+    Result result = {};
+    int64_t turnaroundTotal = 0, shortTotal = 0, longTotal = 0, waitTotal = 0;
+    int shortCount = 0, longCount = 0;
+    size_t nextArrival = 0, finished = 0;
+    int64_t tick = 0;
+
+    while (finished < jobs.size()) {
+        while (nextArrival < jobs.size() && jobs[nextArrival].arrival <= tick) {
+            policy.admit(consoles[nextArrival].get(), tick);
+            nextArrival++;
+        }
+
+        for (int i = 0; i < cores; ++i) {
+            if (running[i].process != nullptr) continue;
+            AConsole* process = policy.pickNext(tick);
+            if (process == nullptr) break;
+            process->dispatch(i);
+            running[i] = { process, (size_t)process->getProcessID() - 1, 0, policy.timeslice(process) };
+            result.dispatches++;
+        }
+
+        tick++;
+        for (int i = 0; i < cores; ++i) {
+            Core& core = running[i];
+            if (core.process == nullptr) continue;
+
+            bool hasMore = core.process->executeInstruction();
+            core.executed++;
+            if (!hasMore) {
+                policy.finished(core.process, core.executed, tick);
+                const Job& job = jobs[core.job];
+                int64_t turnaround = tick - job.arrival;
+                turnaroundTotal += turnaround;
+                waitTotal += turnaround - job.instructions;
+                result.maxTurnaround = max(result.maxTurnaround, turnaround);
+                if (job.isShort) {
+                    shortTotal += turnaround;
+                    shortCount++;
+                }
+                else {
+                    longTotal += turnaround;
+                    longCount++;
+                }
+                finished++;
+                core.process = nullptr;
+            }
+            else if (core.slice > 0 && core.executed >= core.slice) {
+                core.process->preempt();
+                policy.requeue(core.process, core.executed, core.slice, tick);
+                core.process = nullptr;
+            }
+        }
+    }
+
+    result.meanTurnaround = turnaroundTotal / (double)jobs.size();
+    result.meanWait = waitTotal / (double)jobs.size();
+    result.meanShortTurnaround = shortCount > 0 ? shortTotal / (double)shortCount : 0;
+    result.meanLongTurnaround = longCount > 0 ? longTotal / (double)longCount : 0;
+    result.makespan = tick;
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int cores = argc > 1 ? stoi(argv[1]) : 4;
+    int count = argc > 2 ? stoi(argv[2]) : 2000;
+    uint64_t seed = argc > 3 ? stoull(argv[3]) : 1;
+
+    vector<Job> jobs = generateWorkload(count, cores, seed);
+    cout << count << " processes on " << cores << " cores, seed " << seed << ", "
+         << (int)(SHORT_FRACTION * 100) << "% short (" << SHORT_JOB_MIN << "-" << SHORT_JOB_MAX << " instructions), "
+         << "the rest long (" << LONG_JOB_MIN << "-" << LONG_JOB_MAX << "), load " << TARGET_LOAD << ", quantum " << QUANTUM << "\n\n";
+
+    vector<pair<string, unique_ptr<SchedulerPolicy>>> policies;
+    policies.emplace_back("fcfs", make_unique<FifoPolicy>(0));
+    policies.emplace_back("rr", make_unique<FifoPolicy>(QUANTUM));
+    policies.emplace_back("sjf", make_unique<RemainingTimePolicy>(false, QUANTUM, true));
+    policies.emplace_back("srtf", make_unique<RemainingTimePolicy>(true, QUANTUM, true));
+    policies.emplace_back("mlfq", make_unique<MlfqPolicy>(vector<int>{ QUANTUM, QUANTUM * 2, QUANTUM * 4 }, 100, true));
+    policies.emplace_back("fair", make_unique<FairPolicy>(QUANTUM * 8, 1, cores, true));
+
+    cout << left << setw(8) << "policy" << right
+         << setw(14) << "turnaround" << setw(12) << "wait" << setw(14) << "short"
+         << setw(14) << "long" << setw(14) << "max" << setw(12) << "makespan" << setw(12) << "dispatches" << "\n";
+    for (auto& [name, policy] : policies) {
+        Result result = simulate(jobs, cores, *policy);
+        cout << left << setw(8) << name << right << fixed << setprecision(1)
+             << setw(14) << result.meanTurnaround << setw(12) << result.meanWait
+             << setw(14) << result.meanShortTurnaround << setw(14) << result.meanLongTurnaround
+             << setw(14) << result.maxTurnaround << setw(12) << result.makespan << setw(12) << result.dispatches << "\n";
+    }
+    cout << "\nTimes are in ticks; short and long are mean turnarounds of each class.\n";
+    return 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <iostream>
+
+using namespace std;
+
+/*
+* The assertion helpers shared by the unit tests. A failed check prints what
+* was expected and the test keeps going, so one run reports every failure.
+*/
+inline int checkFailures = 0;
+
+/*
+* This function records a failure if the condition does not hold
+*
+* @param condition - the result being checked
+* @param description - what was expected
+*/
+inline void check(bool condition, const char* description) {
+    if (!condition) {
+        cerr << "FAILED: " << description << "\n";
+        checkFailures++;
+    }
+}
+
+/*
+* This function reports the outcome of a test executable
+*
+* @param suite - the name of the code under test
+* @return the exit code, 0 if every check passed
+*/
+inline int finishTests(const char* suite) {
+    if (checkFailures == 0) cout << suite << " tests passed\n";
+    return checkFailures == 0 ? 0 : 1;
+}
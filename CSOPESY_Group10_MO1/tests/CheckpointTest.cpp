@@ -0,0 +1,133 @@
+/*
+* Tests for checkpoint files: a saved checkpoint reads back with the same
+* configuration and records, and a damaged file is rejected when it is opened
+* rather than trusted by the restore.
+*/
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <filesystem>
+#include "../Checkpoint.h"
+#include "Check.h"
+
+using namespace std;
+
+/*
+* This function rewrites a checkpoint file with one change applied
+*
+* @param fileName - the checkpoint file
+* @param original - the bytes of the good checkpoint
+* @param change - edits the header and records in place
+*/
+template <typename Fn>
+void corrupt(const string& fileName, const string& original, Fn change) {
+    string bytes = original;
+    CheckpointHeader* header = reinterpret_cast<CheckpointHeader*>(bytes.data());
+    CheckpointRecord* records = reinterpret_cast<CheckpointRecord*>(bytes.data() + sizeof(CheckpointHeader));
+    change(*header, records);
+    ofstream outFile(fileName, ios::out | ios::trunc | ios::binary);
+    outFile.write(bytes.data(), bytes.size());
+}
+
+/*
+* This function checks that a damaged checkpoint is rejected
+*
+* @param fileName - the checkpoint file
+* @param original - the bytes of the good checkpoint
+* @param change - edits the header and records in place
+* @param description - what was expected
+*/
+template <typename Fn>
+void checkRejected(const string& fileName, const string& original, Fn change, const char* description) {
+    corrupt(fileName, original, change);
+    CheckpointReader reader;
+    string error;
+    check(!reader.open(fileName, error) && !error.empty(), description);
+}
+
+int main() {
+    string fileName = (filesystem::temp_directory_path() / "csopesy_checkpoint_test.ckpt").string();
+
+    CheckpointHeader config = {};
+    config.numCpu = 4;
+    config.quantumCycles = 5;
+    config.minIns = 10;
+    config.maxIns = 20;
+    config.nextProcessId = 4;
+    config.mlfqLevels = 3;
+    config.mlfqQuantumCount = 2;
+    config.mlfqQuantums[0] = 2;
+    config.mlfqQuantums[1] = 4;
+    strncpy(config.scheduler, "rr", sizeof(config.scheduler) - 1);
+
+    vector<CheckpointProcess> processes = {
+        { 2, "process02", "01/01/2026, 10:00:00 AM", 7, { 3, 10, 1, AConsole::RUNNING } },
+        { 1, "process01", "01/01/2026, 09:59:59 AM", 8, { 0, 20, -1, AConsole::WAITING } },
+        { 3, "worker", "01/01/2026, 10:00:01 AM", 9, { 15, 15, -1, AConsole::TERMINATED } },
+    };
+    check(CheckpointWriter::save(fileName, config, "trace.bin", processes), "the checkpoint is written");
+
+    {
+        CheckpointReader reader;
+        string error;
+        check(reader.open(fileName, error), "the checkpoint is read back");
+        const CheckpointHeader& header = reader.header();
+        check(header.numCpu == 4 && header.quantumCycles == 5 && header.nextProcessId == 4, "the configuration is kept");
+        check(header.mlfqQuantumCount == 2 && header.mlfqQuantums[1] == 4, "the mlfq quantums are kept");
+        check(string(header.scheduler) == "rr", "the scheduler is kept");
+        check(reader.traceFile() == "trace.bin", "the trace file is kept");
+        check(header.processCount == processes.size(), "every process is saved");
+        for (size_t i = 0; i < processes.size() && i < header.processCount; ++i) {
+            const CheckpointRecord& record = reader.record(i);
+            const CheckpointProcess& process = processes[i];
+            check(record.processID == process.processID && record.delaySeed == process.delaySeed, "records keep their PID and seed, in order");
+            check(record.instructionLine == process.state.instructionLine && record.instructionTotal == process.state.instructionTotal
+                && record.coreID == process.state.coreID && record.status == process.state.status, "records keep their state");
+            check(reader.name(record) == process.name && reader.timestamp(record) == process.timestamp, "records keep their strings");
+        }
+    }
+
+    string original;
+    {
+        ifstream inFile(fileName, ios::in | ios::binary);
+        original.assign(istreambuf_iterator<char>(inFile), istreambuf_iterator<char>());
+    }
+
+    checkRejected(fileName, original, [](CheckpointHeader& header, CheckpointRecord*) { header.magic[0] = 'X'; },
+        "a file without the magic is rejected");
+    checkRejected(fileName, original, [](CheckpointHeader& header, CheckpointRecord*) { header.version++; },
+        "another version is rejected");
+    checkRejected(fileName, original, [](CheckpointHeader& header, CheckpointRecord*) { header.processCount = UINT64_MAX / sizeof(CheckpointRecord) + 2; },
+        "a process count that wraps the records size is rejected");
+    checkRejected(fileName, original, [](CheckpointHeader& header, CheckpointRecord*) { header.stringsSize = UINT64_MAX; },
+        "strings past the end of the file are rejected");
+    checkRejected(fileName, original, [](CheckpointHeader& header, CheckpointRecord*) { header.traceFileOffset = UINT64_MAX - 1; },
+        "a trace file offset that wraps is rejected");
+    checkRejected(fileName, original, [](CheckpointHeader& header, CheckpointRecord*) { header.mlfqQuantumCount = CHECKPOINT_MAX_MLFQ_LEVELS + 1; },
+        "too many mlfq quantums are rejected");
+    checkRejected(fileName, original, [](CheckpointHeader&, CheckpointRecord* records) { records[0].processID = 2000000000; },
+        "a PID at or past the next process ID is rejected");
+    checkRejected(fileName, original, [](CheckpointHeader&, CheckpointRecord* records) { records[1].processID = 0; },
+        "a PID below 1 is rejected");
+    checkRejected(fileName, original, [](CheckpointHeader&, CheckpointRecord* records) { records[0].instructionLine = 11; },
+        "a line past the total is rejected");
+    checkRejected(fileName, original, [](CheckpointHeader&, CheckpointRecord* records) { records[2].instructionTotal = 0; },
+        "a total below 1 is rejected");
+    checkRejected(fileName, original, [](CheckpointHeader&, CheckpointRecord* records) { records[1].status = 7; },
+        "an unknown status is rejected");
+    checkRejected(fileName, original, [](CheckpointHeader&, CheckpointRecord* records) { records[0].coreID = 4; },
+        "a core past num-cpu is rejected");
+
+    // A name outside the string data reads as empty instead of past the mapping
+    corrupt(fileName, original, [](CheckpointHeader&, CheckpointRecord* records) { records[0].nameOffset = UINT64_MAX - 2; });
+    {
+        CheckpointReader reader;
+        string error;
+        check(reader.open(fileName, error), "a bad name offset does not reject the file");
+        check(reader.name(reader.record(0)).empty(), "a name offset that wraps reads as empty");
+    }
+
+    filesystem::remove(fileName);
+    return finishTests("Checkpoint");
+}
@@ -0,0 +1,68 @@
+/*
+* Tests for the fair scheduler: the process with the smallest virtual runtime
+* runs first with ties going to the lower PID, a late arrival starts one slice
+* past the smallest virtual runtime, the slice never drops below the minimum
+* granularity, and Jain's index reflects the service rates.
+*/
+#include <ctime>
+#include <sstream>
+#include "../FairPolicy.h"
+#include "Check.h"
+
+using namespace std;
+
+int main() {
+    AConsole first(1, 100, time(0));
+    AConsole second(2, 100, time(0));
+    AConsole third(3, 100, time(0));
+
+    {
+        FairPolicy policy(12, 2, 1, true);
+        policy.admit(&first, 0);
+        check(first.getSchedulingInfo().vruntime == 12, "a lone arrival starts one full latency past 0");
+        policy.admit(&second, 0);
+        check(second.getSchedulingInfo().vruntime == 6, "the latency is split among the runnable processes");
+        check(policy.size() == 2, "admitted processes are counted");
+
+        check(policy.pickNext(0) == &second, "the smallest virtual runtime runs first");
+        check(policy.timeslice(&second) == 6, "the dispatched process still shares the latency");
+        policy.requeue(&second, 6, 6, 6);
+        check(second.getSchedulingInfo().vruntime == 12, "a requeued process is charged what it ran");
+
+        check(policy.pickNext(6) == &first, "equal virtual runtimes go to the lower PID");
+        policy.requeue(&first, 3, 6, 9);
+        check(policy.pickNext(9) == &second, "a process that ran less goes ahead");
+
+        policy.admit(&third, 9);
+        check(third.getSchedulingInfo().vruntime == 18, "a late arrival starts one slice past the smallest virtual runtime");
+        check(policy.pickNext(12) == &first && policy.pickNext(12) == &third, "a late arrival does not overtake waiting processes");
+        check(policy.pickNext(12) == nullptr, "an empty tree has nothing to run");
+    }
+
+    {
+        FairPolicy policy(12, 4, 2, true);
+        AConsole* processes[] = { &first, &second, &third };
+        for (AConsole* process : processes) policy.admit(process, 0);
+        check(policy.timeslice(&first) == 6, "the latency is split per core");
+
+        AConsole more[] = { AConsole(4, 100, time(0)), AConsole(5, 100, time(0)), AConsole(6, 100, time(0)) };
+        for (AConsole& process : more) policy.admit(&process, 0);
+        check(policy.timeslice(&first) == 4, "the slice never drops below the minimum granularity");
+    }
+
+    {
+        FairPolicy policy(12, 2, 1, true);
+        AConsole fast(7, 300, time(0));
+        AConsole slow(8, 100, time(0));
+        policy.admit(&fast, 0);
+        policy.admit(&slow, 0);
+        policy.finished(&fast, 0, 100);
+        policy.finished(&slow, 0, 100);
+
+        ostringstream stats;
+        policy.printStats(stats);
+        check(stats.str().find("Jain's fairness index: 0.800 over 2 finished") != string::npos, "Jain's index compares the service rates");
+    }
+
+    return finishTests("FairPolicy");
+}
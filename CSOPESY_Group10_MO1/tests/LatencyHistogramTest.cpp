@@ -0,0 +1,76 @@
+/*
+* Tests for the latency histogram: small values get exact buckets, larger
+* ones land in a bucket whose upper bound is at most 1/16 above them with no
+* gaps between buckets, and percentiles fall within that error and never
+* exceed the maximum.
+*/
+#include <cstdint>
+#include <vector>
+#include "../LatencyHistogram.h"
+#include "Check.h"
+
+using namespace std;
+
+/*
+* This function returns the upper bound of the bucket a value falls in. A
+* larger value is recorded alongside it so the median is the value's bucket
+* rather than the maximum it would be clamped to.
+*
+* @param value - the value
+* @return the upper bound of its bucket
+*/
+uint64_t boundOf(int64_t value) {
+    LatencyHistogram histogram;
+    histogram.record(value);
+    histogram.record(INT64_MAX);
+    return histogram.percentile(0.5);
+}
+
+int main() {
+    vector<int64_t> values;
+    for (int64_t value = 0; value < 4096; ++value) values.push_back(value);
+    for (int bit = 12; bit < 61; ++bit) {
+        int64_t power = (int64_t)1 << bit;
+        values.insert(values.end(), { power - 1, power, power + 1, power + power / 3 });
+    }
+
+    bool exact = true;
+    bool bounded = true;
+    bool contiguous = true;
+    for (int64_t value : values) {
+        uint64_t bound = boundOf(value);
+        if (value < 16 && bound != (uint64_t)value) exact = false;
+        if (bound < (uint64_t)value || bound - value > (uint64_t)value / 16) bounded = false;
+        // The next value up must start a new bucket
+        if (boundOf((int64_t)bound + 1) <= bound) contiguous = false;
+    }
+    check(exact, "values below 16 have a bucket each");
+    check(bounded, "a bucket's upper bound is at most 1/16 above its values");
+    check(contiguous, "buckets follow one another without gaps");
+    check(boundOf(31) == 31 && boundOf(32) == 33 && boundOf(64) == 67, "each power of two splits into 16 buckets of equal width");
+
+    LatencyHistogram histogram;
+    check(histogram.percentile(0.5) == 0 && histogram.count() == 0, "an empty histogram reports 0");
+
+    for (int64_t value = 1000; value >= 1; --value) histogram.record(value);
+    check(histogram.count() == 1000 && histogram.max() == 1000, "the count and maximum are exact");
+
+    uint64_t p50 = histogram.percentile(0.5);
+    uint64_t p90 = histogram.percentile(0.9);
+    uint64_t p99 = histogram.percentile(0.99);
+    check(p50 >= 500 && p50 <= 500 + 500 / 16, "the median is within the bucket error");
+    check(p90 >= 900 && p90 <= 900 + 900 / 16, "p90 is within the bucket error");
+    check(p99 >= 990 && p99 <= 1000, "p99 is within the bucket error and at most the maximum");
+    check(p50 <= p90 && p90 <= p99 && p99 <= histogram.percentile(1.0), "percentiles never decrease");
+    check(histogram.percentile(1.0) == 1000, "the top percentile is clamped to the maximum");
+
+    LatencyHistogram negative;
+    negative.record(-5);
+    check(negative.count() == 1 && negative.max() == 0 && negative.percentile(0.5) == 0, "a negative latency counts as 0");
+
+    LatencyHistogram largest;
+    largest.record(INT64_MAX);
+    check(largest.percentile(0.5) == (uint64_t)INT64_MAX, "the largest latency has a bucket");
+
+    return finishTests("LatencyHistogram");
+}
@@ -0,0 +1,52 @@
+/*
+* Tests for the flat memory allocator: released neighbours coalesce into one
+* free block, and first-fit and best-fit place processes where expected.
+*/
+#include "../MemoryManager.h"
+#include "Check.h"
+
+using namespace std;
+
+int main() {
+    MemoryManager memory;
+    memory.configure(4096, 1024, MemoryManager::FIRST_FIT);
+
+    for (int pid = 1; pid <= 4; ++pid) {
+        check(memory.allocate(pid), "processes are placed while memory lasts");
+    }
+    check(!memory.allocate(5), "allocation fails when memory is full");
+    check(memory.getStats().freeBlocks == 0, "full memory has no free blocks");
+
+    // Holes at 0 and 2048 are not neighbours
+    memory.release(1);
+    memory.release(3);
+    MemoryManager::Stats stats = memory.getStats();
+    check(stats.freeBlocks == 2, "separate holes stay separate");
+    check(stats.largestFreeBlock == 1024, "each hole holds one process");
+
+    // Releasing the process between them merges all three
+    memory.release(2);
+    stats = memory.getStats();
+    check(stats.freeBlocks == 1, "a released block merges with both neighbours");
+    check(stats.largestFreeBlock == 3072, "the merged block spans all three");
+
+    memory.release(4);
+    stats = memory.getStats();
+    check(stats.freeBlocks == 1 && stats.largestFreeBlock == 4096, "releasing everything leaves one block");
+    check(stats.usedMemory == 0, "no memory is in use after releasing everything");
+    check(!memory.release(4), "releasing twice fails");
+
+    // Best-fit takes the smallest hole that fits: free 1024 at 0 and 2048 at 2048
+    MemoryManager bestFit;
+    bestFit.configure(4096, 1024, MemoryManager::BEST_FIT);
+    for (int pid = 1; pid <= 4; ++pid) bestFit.allocate(pid);
+    bestFit.release(1);
+    bestFit.release(3);
+    bestFit.release(4);
+    check(bestFit.getStats().freeBlocks == 2, "the last two blocks merge, the first stays apart");
+    check(bestFit.allocate(5), "best-fit places a process");
+    stats = bestFit.getStats();
+    check(stats.freeBlocks == 1 && stats.largestFreeBlock == 2048, "best-fit fills the exact hole and keeps the large one");
+
+    return finishTests("MemoryManager");
+}
@@ -0,0 +1,77 @@
+/*
+* Tests for the multi-level feedback queue: a process that uses its whole
+* quantum drops a level and one that yields early keeps its level, higher
+* levels always run first, a boost returns every process to level 0 in order,
+* and default quantums double without overflowing.
+*/
+#include <climits>
+#include <ctime>
+#include <sstream>
+#include "../MlfqPolicy.h"
+#include "Check.h"
+
+using namespace std;
+
+int main() {
+    AConsole first(1, 100, time(0));
+    AConsole second(2, 100, time(0));
+    AConsole third(3, 100, time(0));
+
+    {
+        MlfqPolicy policy({ 2, 4, 8 }, 0, true);
+        policy.admit(&first, 0);
+        policy.admit(&second, 0);
+        check(policy.size() == 2, "admitted processes are counted");
+
+        check(policy.pickNext(1) == &first, "level 0 runs in arrival order");
+        check(policy.timeslice(&first) == 2, "level 0 has the first quantum");
+        policy.requeue(&first, 2, 2, 3);
+        check(first.getSchedulingInfo().level == 1, "a process that used its whole quantum drops a level");
+
+        check(policy.pickNext(3) == &second, "level 0 runs before level 1");
+        policy.requeue(&second, 1, 2, 4);
+        check(second.getSchedulingInfo().level == 0, "a process that yielded early keeps its level");
+
+        check(policy.pickNext(4) == &second, "a process left at level 0 runs before a demoted one");
+        policy.finished(&second, 1, 5);
+        check(policy.pickNext(5) == &first, "level 1 runs once level 0 is empty");
+        check(policy.timeslice(&first) == 4, "level 1 has the second quantum");
+
+        policy.requeue(&first, 4, 4, 9);
+        check(policy.pickNext(9) == &first && first.getSchedulingInfo().level == 2, "a demoted process drops again");
+        policy.requeue(&first, 8, 8, 17);
+        check(first.getSchedulingInfo().level == 2, "the bottom level keeps its processes");
+        check(policy.pickNext(17) == &first && policy.size() == 0, "the queue empties");
+        check(policy.pickNext(18) == nullptr, "an empty queue has nothing to run");
+    }
+
+    {
+        MlfqPolicy policy({ 1, 2, 4 }, 3, true);
+        policy.admit(&first, 0);
+        policy.admit(&second, 0);
+        policy.admit(&third, 0);
+        for (int i = 0; i < 3; ++i) {
+            AConsole* process = policy.pickNext(i);
+            policy.requeue(process, 1, 1, i);
+        }
+        check(first.getSchedulingInfo().level == 1 && third.getSchedulingInfo().level == 1, "every process was demoted");
+
+        check(policy.pickNext(3) == &first, "the boost keeps the order of the levels it empties");
+        check(first.getSchedulingInfo().level == 0 && second.getSchedulingInfo().level == 0 && third.getSchedulingInfo().level == 0,
+            "the boost returns every process to level 0");
+        check(policy.pickNext(3) == &second && policy.pickNext(3) == &third, "boosted processes keep their order");
+
+        ostringstream stats;
+        policy.printStats(stats);
+        check(stats.str().find("MLFQ priority boosts: 1") != string::npos, "the boost is counted");
+    }
+
+    vector<int> doubled = MlfqPolicy::levelQuantums({}, 4, 5);
+    check(doubled == vector<int>({ 5, 10, 20, 40 }), "unlisted levels double the level above");
+    vector<int> listed = MlfqPolicy::levelQuantums({ 3, 7 }, 3, 5);
+    check(listed == vector<int>({ 3, 7, 14 }), "listed quantums are kept and the rest double");
+    vector<int> deep = MlfqPolicy::levelQuantums({}, MlfqPolicy::MAX_LEVELS, 5);
+    check(deep.back() == INT_MAX && deep[30] == INT_MAX, "doubling saturates at INT_MAX");
+
+    return finishTests("MlfqPolicy");
+}
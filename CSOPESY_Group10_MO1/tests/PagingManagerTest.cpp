@@ -0,0 +1,48 @@
+/*
+* Tests for demand paging: pages fault in on first touch, and when memory is
+* full the clock evicts the first frame not used since the hand last passed
+* it, so a page touched again gets a second chance.
+*/
+#include <filesystem>
+#include "../PagingManager.h"
+#include "Check.h"
+
+using namespace std;
+
+int main() {
+    string fileName = (filesystem::temp_directory_path() / "csopesy_paging_test.bin").string();
+
+    {
+        // Three 16-byte frames and four pages per process
+        PagingManager paging;
+        check(paging.configure(48, 16, 64, fileName), "paging is configured");
+        PagingManager::PageTable* table = paging.attach(1);
+        check(table->pageCount == 4 && table->frames[0].load() == -1, "no page is resident before it is touched");
+
+        paging.access(table, 0);
+        paging.access(table, 16);
+        paging.access(table, 32);
+        check(table->frames[0].load() == 0 && table->frames[1].load() == 1 && table->frames[2].load() == 2, "pages fault into the low frames first");
+
+        // Every frame is referenced, so the hand clears them all and comes
+        // back to frame 0
+        paging.access(table, 48);
+        check(table->frames[0].load() == -1 && table->frames[3].load() == 0, "with every frame referenced the hand evicts where it started");
+
+        // Page 1 is touched again, so the hand skips its frame and takes page 2's
+        paging.access(table, 16);
+        paging.access(table, 0);
+        check(table->frames[1].load() == 1, "a page touched since the last sweep gets a second chance");
+        check(table->frames[2].load() == -1 && table->frames[0].load() == 2, "the first unreferenced frame is the victim");
+
+        PagingManager::Stats stats = paging.getStats();
+        check(stats.pageFaults == 5 && stats.pagedOut == 2 && stats.pagedIn == 1, "faults and page moves are counted");
+        check(stats.framesUsed == 3, "every frame is in use");
+
+        paging.release(1);
+        check(paging.getStats().framesUsed == 0, "a released process frees its frames");
+    }
+
+    filesystem::remove(fileName);
+    return finishTests("PagingManager");
+}
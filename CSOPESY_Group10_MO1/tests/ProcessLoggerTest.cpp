@@ -0,0 +1,61 @@
+/*
+* Tests for the process log: a process that moves between cores logs to a
+* different ring on each, and its log file still lists every instruction in
+* the order it ran, with the finish line last.
+*/
+#include <cstdlib>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include "../ProcessLogger.h"
+#include "Check.h"
+
+using namespace std;
+
+int main() {
+    filesystem::path directory = filesystem::temp_directory_path() / "csopesy_process_logger_test";
+    filesystem::remove_all(directory);
+
+    processLogger.start(2, ProcessLogger::ALL, directory.string(), [](int pid) {
+        return "process" + to_string(pid);
+    });
+
+    // The process runs lines 1 to 3 on core 1 and lines 4 to 6 on core 0.
+    // Core 0's ring is drained first, so without the sequence its later
+    // lines would be written ahead of the earlier ones.
+    uint32_t sequence = 0;
+    for (uint32_t line = 1; line <= 3; ++line) {
+        processLogger.logInstruction(1, 7, sequence, line, Program::DECLARE, 0, (uint16_t)line);
+    }
+    for (uint32_t line = 4; line <= 6; ++line) {
+        processLogger.logInstruction(0, 7, sequence, line, Program::DECLARE, 0, (uint16_t)line);
+    }
+    processLogger.logFinished(0, 7, sequence, 6);
+    check(sequence == 7, "every kept record advances the sequence");
+    processLogger.flush();
+
+    vector<string> lines;
+    {
+        ifstream file(directory / "process7.txt");
+        string line;
+        while (getline(file, line)) lines.push_back(line);
+    }
+
+    check(lines.size() == 7, "every record is written once");
+    for (size_t i = 0; i < lines.size() && i < 6; ++i) {
+        string expected = "DECLARE x0 = " + to_string(i + 1);
+        string core = i < 3 ? "Core:1 " : "Core:0 ";
+        check(lines[i].find(expected) != string::npos && lines[i].find(core) != string::npos, "records are written in the order they ran");
+    }
+    if (lines.size() == 7) {
+        check(lines[6].find("Finished after 6 instructions") != string::npos, "the finish line comes last");
+    }
+
+    filesystem::remove_all(directory);
+
+    // The logger's writer thread never stops, so leave without running
+    // static destructors under it
+    int result = finishTests("ProcessLogger");
+    cout.flush();
+    quick_exit(result);
+}
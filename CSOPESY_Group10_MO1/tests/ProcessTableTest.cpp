@@ -0,0 +1,50 @@
+/*
+* Tests for the process table: names and PIDs are found through both
+* indexes, and a name derived from a PID never duplicates a stored name in
+* either direction.
+*/
+#include <ctime>
+#include "../ProcessTable.h"
+#include "Check.h"
+
+using namespace std;
+
+int main() {
+    ProcessTable table;
+
+    AConsole* named = new AConsole(100, "process042", 10);
+    check(table.insert(named), "a named process is added");
+    check(table.find("process042") == named, "a named process is found by name");
+    check(table.findByPid(100) == named, "a named process is found by PID");
+
+    AConsole* duplicate = new AConsole(101, "process042", 10);
+    check(!table.insert(duplicate), "a duplicate name is rejected");
+
+    // PIDs 40 to 44; PID 42 would be named like the stored process
+    AConsole* generated[5];
+    for (int i = 0; i < 5; ++i) {
+        generated[i] = new AConsole(40 + i, 10, time(0));
+    }
+    AConsole* taken = generated[2];
+    check(table.insertGenerated(generated, 5) == 4, "a generated name that is already stored is skipped");
+    check(generated[4] == taken, "the skipped process is moved to the end");
+    check(generated[0]->getProcessID() == 40 && generated[1]->getProcessID() == 41
+        && generated[2]->getProcessID() == 43 && generated[3]->getProcessID() == 44, "the added processes keep their order");
+
+    check(table.find("process042") == named, "the stored name still finds the named process");
+    check(table.findByPid(42) == nullptr, "the skipped PID is not in the table");
+    check(table.find("process041") == generated[1], "a generated process is found by its derived name");
+    check(table.findByPid(44) == generated[3], "a generated process is found by PID");
+    check(table.size() == 5, "the table counts named and generated processes");
+
+    AConsole* clash = new AConsole(102, "process041", 10);
+    check(!table.insert(clash), "a name derived from a live PID is rejected");
+
+    check(table.remove(41) == generated[1], "remove returns the process");
+    check(table.find("process041") == nullptr, "a removed process is no longer found");
+    check(table.insert(clash), "the name is free once the PID is removed");
+    check(table.find("process041") == clash, "the new process owns the name");
+    check(table.findByPid(40) == generated[0] && table.findByPid(43) == generated[2], "removal keeps the other slots indexed");
+
+    return finishTests("ProcessTable");
+}
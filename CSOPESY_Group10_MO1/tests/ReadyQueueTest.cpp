@@ -0,0 +1,48 @@
+/*
+* Tests for the waiting queue: bulk pushes keep their order, stop at the
+* capacity and interleave correctly with single pushes and pops across laps
+* of the ring.
+*/
+#include <vector>
+#include "../ReadyQueue.h"
+#include "Check.h"
+
+using namespace std;
+
+int main() {
+    ReadyQueue<int> queue(8);
+    check(queue.capacity() == 8, "capacity is rounded to a power of two");
+
+    vector<int> values = { 1, 2, 3, 4, 5 };
+    check(queue.tryPushBulk(values.data(), values.size()) == 5, "bulk push into an empty queue takes every value");
+    check(queue.sizeApprox() == 5, "size counts the bulk push");
+
+    // Only three cells are left
+    vector<int> more = { 6, 7, 8, 9, 10 };
+    check(queue.tryPushBulk(more.data(), more.size()) == 3, "bulk push stops at the capacity");
+    check(!queue.tryPush(11), "push into a full queue fails");
+    check(queue.tryPushBulk(more.data(), more.size()) == 0, "bulk push into a full queue takes nothing");
+
+    for (int expected = 1; expected <= 8; ++expected) {
+        int value = 0;
+        check(queue.tryPop(value) && value == expected, "values come out in push order");
+    }
+    int value = 0;
+    check(!queue.tryPop(value), "pop from an empty queue fails");
+
+    // Go around the ring several times with mixed single and bulk pushes
+    int next = 0;
+    int expected = 0;
+    for (int lap = 0; lap < 20; ++lap) {
+        vector<int> batch = { next, next + 1, next + 2 };
+        check(queue.tryPushBulk(batch.data(), batch.size()) == 3, "bulk push after wrapping");
+        check(queue.tryPush(next + 3), "single push after a bulk push");
+        next += 4;
+        for (int i = 0; i < 4; ++i) {
+            check(queue.tryPop(value) && value == expected++, "order is kept across laps");
+        }
+    }
+    check(queue.empty(), "queue is empty after draining");
+
+    return finishTests("ReadyQueue");
+}
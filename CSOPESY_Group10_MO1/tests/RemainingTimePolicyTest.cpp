@@ -0,0 +1,55 @@
+/*
+* Tests for shortest job first and shortest remaining time first: the process
+* with the fewest instructions left runs first with ties going to the lower
+* PID, a preempted process goes back with its new remaining count, and only
+* srtf limits the slice.
+*/
+#include <ctime>
+#include <sstream>
+#include "../RemainingTimePolicy.h"
+#include "Check.h"
+
+using namespace std;
+
+int main() {
+    AConsole longest(1, 30, time(0));
+    AConsole shortest(2, 10, time(0));
+    AConsole middle(3, 20, time(0));
+    AConsole tied(4, 20, time(0));
+
+    {
+        RemainingTimePolicy policy(true, 8, true);
+        policy.admit(&longest, 0);
+        policy.admit(&shortest, 0);
+        policy.admit(&middle, 0);
+        check(policy.size() == 3, "admitted processes are counted");
+        check(policy.timeslice(&shortest) == 8, "srtf runs one quantum at a time");
+
+        check(policy.pickNext(0) == &shortest, "the fewest remaining instructions run first");
+        shortest.setInstructionLine(8);
+        policy.requeue(&shortest, 8, 8, 8);
+        check(policy.pickNext(8) == &shortest, "a preempted process goes back with its new remaining count");
+
+        policy.admit(&tied, 10);
+        check(policy.pickNext(10) == &middle, "equal remaining counts go to the lower PID");
+        middle.setInstructionLine(8);
+        policy.requeue(&middle, 8, 8, 18);
+        check(policy.pickNext(18) == &middle, "a process that ran overtakes one with more left");
+        check(policy.pickNext(18) == &tied && policy.pickNext(18) == &longest, "the rest run shortest first");
+        check(policy.pickNext(18) == nullptr, "an empty heap has nothing to run");
+
+        ostringstream stats;
+        policy.printStats(stats);
+        check(stats.str().find("SRTF scheduler: 0 runnable, 6 dispatches, 2 preemptions") != string::npos, "dispatches and preemptions are counted");
+    }
+
+    {
+        RemainingTimePolicy policy(false, 8, true);
+        check(policy.timeslice(&longest) == 0, "sjf runs a process to completion");
+        policy.admit(&longest, 0);
+        policy.admit(&middle, 0);
+        check(policy.pickNext(0) == &middle && policy.pickNext(0) == &longest, "sjf also runs the shortest first");
+    }
+
+    return finishTests("RemainingTimePolicy");
+}
@@ -0,0 +1,56 @@
+/*
+* Tests for workload traces: every recorded arrival replays with the same
+* instruction count and delay seed, in order, and the replay adopts the seed
+* it was recorded with. A fixed seed and stream generate the same arrivals.
+*/
+#include <vector>
+#include <filesystem>
+#include "../Workload.h"
+#include "Check.h"
+
+using namespace std;
+
+int main() {
+    string traceFile = (filesystem::temp_directory_path() / "csopesy_workload_test.trace").string();
+
+    Workload recorder;
+    check(recorder.configure(42, Workload::RECORD, traceFile, 5, 50), "the trace is created");
+    recorder.seedThread(1);
+
+    vector<Workload::Arrival> arrivals(20);
+    recorder.nextBatch(arrivals.data(), 10);
+    for (size_t i = 10; i < arrivals.size(); ++i) {
+        arrivals[i] = recorder.next();
+    }
+    for (const Workload::Arrival& arrival : arrivals) {
+        check(arrival.instructions >= 5 && arrival.instructions <= 50, "instruction counts are in range");
+    }
+
+    Workload replayer;
+    check(replayer.configure(7, Workload::REPLAY, traceFile, 1, 1), "the trace is read back");
+    check(replayer.getMode() == Workload::REPLAY, "the workload replays");
+    check(replayer.getSeed() == 42, "the replay adopts the recorded seed");
+    check(replayer.replayLength() == arrivals.size(), "every arrival is replayed");
+
+    for (size_t i = 0; i < replayer.replayLength() && i < arrivals.size(); ++i) {
+        Workload::Arrival replayed = replayer.replayed(i);
+        check(replayed.instructions == arrivals[i].instructions, "instruction counts round-trip");
+        check(replayed.delaySeed == arrivals[i].delaySeed, "delay seeds round-trip");
+        check(i == 0 ? replayed.arrivalNs == 0 : replayed.arrivalNs >= replayer.replayed(i - 1).arrivalNs, "arrival times start at zero and never go backwards");
+    }
+
+    // The same seed and stream generate the same arrivals again
+    Workload generator;
+    generator.configure(42, Workload::GENERATE, traceFile, 5, 50);
+    generator.seedThread(1);
+    vector<Workload::Arrival> again(arrivals.size());
+    generator.nextBatch(again.data(), again.size());
+    for (size_t i = 0; i < again.size(); ++i) {
+        check(again[i].instructions == arrivals[i].instructions && again[i].delaySeed == arrivals[i].delaySeed, "a fixed seed regenerates the workload");
+    }
+
+    error_code ignored;
+    filesystem::remove(traceFile, ignored);
+
+    return finishTests("Workload");
+}